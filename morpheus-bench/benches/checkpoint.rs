@@ -1,13 +1,204 @@
-//! Criterion benchmarks for checkpoint overhead
+//! Criterion benchmarks for the Morpheus hot-path primitives
+//!
+//! Covers every operation that multiplies by the ~10^9 daily checkpoint
+//! count: the checkpoint itself (detached, attached-quiescent, and
+//! attached while the kernel-side cache line is being written),
+//! critical-section enter/exit in both publication modes, the SCB
+//! atomic round trip, hint parsing, and executor spawn/wake.
+//!
+//! SCB-attached cases run against the simulation backend
+//! ([`morpheus_runtime::sim`]), so the suite needs no root and no
+//! sched_ext kernel - it runs on every PR.
+//!
+//! Regression tracking uses criterion's built-in baselines:
+//!
+//! ```text
+//! cargo bench --bench checkpoint -- --save-baseline main
+//! cargo bench --bench checkpoint -- --baseline main
+//! ```
 
-use criterion::{black_box, criterion_group, criterion_main, Criterion};
-use morpheus_runtime::checkpoint_sync;
+use criterion::{black_box, criterion_group, criterion_main, Criterion, Throughput};
+use morpheus_runtime::executor::{ExecutorShared, LocalExecutor};
+use morpheus_runtime::ringbuf::{DefensiveMode, HintConsumer};
+use morpheus_runtime::sim::{SimConfig, SimKernel};
+use morpheus_runtime::{checkpoint_sync, critical_section, set_lazy_publication, worker};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::Arc;
 
-fn checkpoint_benchmark(c: &mut Criterion) {
-    c.bench_function("checkpoint_sync (no SCB)", |b| {
+/// Attach the benchmark thread to a fresh simulated SCB
+fn attach_scb(sim: &SimKernel, worker_id: u32) {
+    let scb = sim.scb_handle(worker_id, true).expect("sim scb");
+    worker::set_current_scb(scb, worker_id);
+}
+
+fn bench_checkpoint(c: &mut Criterion) {
+    let mut group = c.benchmark_group("checkpoint");
+    group.throughput(Throughput::Elements(1));
+
+    // No SCB installed: the detached fast path
+    worker::clear_current_scb();
+    group.bench_function("sync_no_scb", |b| b.iter(|| black_box(checkpoint_sync())));
+
+    // Attached, quiescent: the common case in production
+    let sim = SimKernel::start(SimConfig::default());
+    attach_scb(&sim, 0);
+    group.bench_function("sync_quiescent", |b| b.iter(|| black_box(checkpoint_sync())));
+
+    // Attached while another core writes the checkpoint-critical line:
+    // worst-case coherence traffic on the preempt_seq line
+    let stop = Arc::new(AtomicBool::new(false));
+    let writer_scb = sim.scb_handle(0, true).expect("sim scb");
+    let writer_stop = stop.clone();
+    let writer = std::thread::spawn(move || {
+        while !writer_stop.load(Ordering::Relaxed) {
+            writer_scb
+                .scb()
+                .kernel_pressure_level
+                .fetch_add(1, Ordering::Relaxed);
+        }
+    });
+    group.bench_function("sync_contended_line", |b| {
         b.iter(|| black_box(checkpoint_sync()))
     });
+    stop.store(true, Ordering::Relaxed);
+    writer.join().unwrap();
+
+    worker::clear_current_scb();
+    sim.shutdown();
+    group.finish();
+}
+
+fn bench_critical_section(c: &mut Criterion) {
+    let mut group = c.benchmark_group("critical_section");
+    group.throughput(Throughput::Elements(1));
+
+    let sim = SimKernel::start(SimConfig::default());
+    attach_scb(&sim, 0);
+
+    set_lazy_publication(false);
+    group.bench_function("enter_exit_eager", |b| {
+        b.iter(|| {
+            let _guard = critical_section();
+        })
+    });
+
+    set_lazy_publication(true);
+    group.bench_function("enter_exit_lazy", |b| {
+        b.iter(|| {
+            let _guard = critical_section();
+        })
+    });
+    set_lazy_publication(false);
+
+    group.bench_function("nested_inner", |b| {
+        let _outer = critical_section();
+        b.iter(|| {
+            let _guard = critical_section();
+        })
+    });
+
+    worker::clear_current_scb();
+    sim.shutdown();
+    group.finish();
+}
+
+fn bench_scb_round_trip(c: &mut Criterion) {
+    let mut group = c.benchmark_group("scb");
+    group.throughput(Throughput::Elements(1));
+
+    let sim = SimKernel::start(SimConfig::default());
+    let scb = sim.scb_handle(0, true).expect("sim scb");
+
+    // Full request/observe/acknowledge cycle through the atomics
+    group.bench_function("request_ack_round_trip", |b| {
+        b.iter(|| {
+            scb.scb().preempt_seq.fetch_add(1, Ordering::Release);
+            black_box(scb.yield_requested());
+            scb.acknowledge();
+        })
+    });
+
+    group.bench_function("pending_hint_read", |b| {
+        b.iter(|| black_box(scb.pending_hint()))
+    });
+
+    sim.shutdown();
+    group.finish();
+}
+
+fn bench_hint_parse(c: &mut Criterion) {
+    let mut group = c.benchmark_group("hint");
+    group.throughput(Throughput::Elements(1));
+
+    let consumer = HintConsumer::with_sample_interval(64);
+    // A realistic hint record (seq grows to exercise gap logic)
+    let mut seq = 0u64;
+    group.bench_function("process_hint", |b| {
+        b.iter(|| {
+            seq += 64;
+            let hint = morpheus_runtime::MorpheusHint {
+                seq,
+                reason: 1,
+                target_tid: 1234,
+                deadline_ns: seq + 1_000_000,
+                emit_ns: 0,
+            };
+            let bytes = unsafe {
+                std::slice::from_raw_parts(
+                    &hint as *const _ as *const u8,
+                    std::mem::size_of::<morpheus_runtime::MorpheusHint>(),
+                )
+            };
+            black_box(consumer.process_hint(bytes));
+        })
+    });
+
+    group.finish();
+}
+
+fn bench_executor(c: &mut Criterion) {
+    let mut group = c.benchmark_group("executor");
+    group.throughput(Throughput::Elements(1));
+
+    // Spawn + run a trivial task to completion on the local queue
+    let shared = ExecutorShared::new();
+    let executor = LocalExecutor::new(shared.clone(), Vec::new(), Arc::new(DefensiveMode::new(0)));
+    group.bench_function("spawn_and_run", |b| {
+        b.iter(|| {
+            executor.spawn(async {}).detach();
+            while executor.tick() {}
+        })
+    });
+
+    // A task that yields once: exercises the LIFO-slot wake path
+    group.bench_function("spawn_yield_wake", |b| {
+        b.iter(|| {
+            executor
+                .spawn(async {
+                    morpheus_runtime::executor::yield_now().await;
+                })
+                .detach();
+            while executor.tick() {}
+        })
+    });
+
+    // Cross-thread spawn: injector push + unpark bookkeeping
+    group.bench_function("injector_spawn", |b| {
+        b.iter(|| {
+            shared.spawn(async {}).detach();
+            while executor.tick() {}
+        })
+    });
+
+    group.finish();
 }
 
-criterion_group!(benches, checkpoint_benchmark);
+criterion_group!(
+    benches,
+    bench_checkpoint,
+    bench_critical_section,
+    bench_scb_round_trip,
+    bench_hint_parse,
+    bench_executor
+);
 criterion_main!(benches);
@@ -0,0 +1,457 @@
+//! Multi-process, cgroup-partitioned antagonist benchmark
+//!
+//! The single-process benchmarks (starvation, liar) validate the hint
+//! path. The production incident mode is different: a *neighboring
+//! process* - another tenant's pool, under its own cgroup - goes
+//! CPU-bound and starves our workers, with relief flowing through the
+//! CGROUP_THROTTLE escalation path and the loader's penalty pipeline.
+//! This driver validates that path end-to-end at realistic scale:
+//!
+//! - spawns N victim and M antagonist child processes (re-execing this
+//!   binary with `--role`), each in its own cgroup v2 directory
+//! - drives configurable antagonist patterns: `steady` burn, `bursty`
+//!   on/off burn, and `liar` (critical-section-abusing burn, the
+//!   cross-process version of the liar benchmark)
+//! - measures victim latency distributions, plus time-to-throttle and
+//!   time-to-recover by watching the antagonist cgroups' cpu.max for
+//!   the penalty write and its expiry
+//!
+//! Cgroup placement and the throttle path need root and a running
+//! `scx_morpheus --enforce`; without them the framework still runs the
+//! processes and reports victim latency (with a warning), which is
+//! useful for interference baselines.
+
+use clap::Parser;
+use morpheus_common::{EscalationPolicy, WorkerState};
+use morpheus_runtime::{BpfMaps, ScbHandle};
+use std::io::Write;
+use std::process::{Child, Command};
+use std::sync::atomic::Ordering;
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+
+const CGROUP_ROOT: &str = "/sys/fs/cgroup";
+
+/// Worker-id blocks for benchmark processes, parked in the upper half of
+/// the SCB table so they can't collide with a real pool's ids
+const VICTIM_WORKER_BASE: u32 = 256;
+const ANTAGONIST_WORKER_BASE: u32 = 512;
+
+/// Multi-process antagonist benchmark driver
+#[derive(Parser, Debug, Clone)]
+#[command(author, version, about)]
+struct Args {
+    /// Process role (the driver re-execs itself for children)
+    #[arg(long, default_value = "driver")]
+    role: String,
+
+    /// Number of victim processes
+    #[arg(short = 'v', long, default_value_t = 2)]
+    victims: usize,
+
+    /// Number of antagonist processes
+    #[arg(short = 'a', long, default_value_t = 2)]
+    antagonists: usize,
+
+    /// Antagonist pattern: steady | bursty | liar
+    #[arg(short, long, default_value = "steady")]
+    pattern: String,
+
+    /// Benchmark duration (seconds)
+    #[arg(short, long, default_value_t = 20)]
+    duration: u64,
+
+    /// Burst period for the bursty pattern (ms on, then off)
+    #[arg(long, default_value_t = 500)]
+    burst_ms: u64,
+
+    /// Cgroup name prefix (driver creates <prefix>-victim-N etc.)
+    #[arg(long, default_value = "morpheus-antagonist")]
+    cgroup_prefix: String,
+
+    /// Directory for child result files (driver sets this for children)
+    #[arg(long, default_value = "/tmp/morpheus-antagonist")]
+    results_dir: String,
+
+    /// Child index (set by the driver)
+    #[arg(long, default_value_t = 0)]
+    index: usize,
+
+    /// Directory where scx_morpheus pinned its maps
+    #[arg(long, default_value = "/sys/fs/bpf/morpheus")]
+    pin_dir: String,
+}
+
+fn main() {
+    let args = Args::parse();
+    tracing_subscriber::fmt().with_env_filter("info").init();
+
+    match args.role.as_str() {
+        "driver" => driver(&args),
+        "victim" => victim(&args),
+        "antagonist" => antagonist(&args),
+        other => {
+            eprintln!("unknown role: {}", other);
+            std::process::exit(2);
+        }
+    }
+}
+
+/// Create a cgroup and move a child into it. Best-effort: returns the
+/// cgroup path on success.
+fn place_in_cgroup(prefix: &str, name: &str, pid: u32) -> Option<String> {
+    let path = format!("{}/{}-{}", CGROUP_ROOT, prefix, name);
+    std::fs::create_dir_all(&path).ok()?;
+    std::fs::write(format!("{}/cgroup.procs", path), pid.to_string()).ok()?;
+    Some(path)
+}
+
+/// Watch an antagonist cgroup's cpu.max for the penalty write and its
+/// expiry. Returns (time_to_throttle, time_to_recover) from `start`.
+struct ThrottleWatch {
+    path: String,
+    initial: String,
+    throttled_at: Option<Duration>,
+    recovered_at: Option<Duration>,
+}
+
+impl ThrottleWatch {
+    fn new(cgroup_path: &str) -> Option<Self> {
+        let max_path = format!("{}/cpu.max", cgroup_path);
+        let initial = std::fs::read_to_string(&max_path).ok()?;
+        Some(Self {
+            path: max_path,
+            initial,
+            throttled_at: None,
+            recovered_at: None,
+        })
+    }
+
+    fn poll(&mut self, since_start: Duration) {
+        let Ok(current) = std::fs::read_to_string(&self.path) else {
+            return;
+        };
+        if self.throttled_at.is_none() {
+            if current != self.initial {
+                self.throttled_at = Some(since_start);
+            }
+        } else if self.recovered_at.is_none() && current == self.initial {
+            self.recovered_at = Some(since_start);
+        }
+    }
+}
+
+fn driver(args: &Args) {
+    tracing::info!("Antagonist framework driver");
+    tracing::info!(
+        "  {} victims vs {} antagonists ({} pattern), {}s",
+        args.victims,
+        args.antagonists,
+        args.pattern,
+        args.duration
+    );
+
+    std::fs::create_dir_all(&args.results_dir).expect("results dir");
+    let exe = std::env::current_exe().expect("current_exe");
+
+    let spawn_child = |role: &str, index: usize| -> Child {
+        Command::new(&exe)
+            .args([
+                "--role",
+                role,
+                "--pattern",
+                &args.pattern,
+                "--duration",
+                &args.duration.to_string(),
+                "--burst-ms",
+                &args.burst_ms.to_string(),
+                "--results-dir",
+                &args.results_dir,
+                "--index",
+                &index.to_string(),
+                "--pin-dir",
+                &args.pin_dir,
+            ])
+            .spawn()
+            .expect("spawn child")
+    };
+
+    // Spawn and partition: every process in its own cgroup
+    let mut children = Vec::new();
+    let mut watches = Vec::new();
+    let mut cgroups_ok = true;
+
+    for i in 0..args.victims {
+        let child = spawn_child("victim", i);
+        cgroups_ok &=
+            place_in_cgroup(&args.cgroup_prefix, &format!("victim-{}", i), child.id()).is_some();
+        children.push(child);
+    }
+    for i in 0..args.antagonists {
+        let child = spawn_child("antagonist", i);
+        let placed =
+            place_in_cgroup(&args.cgroup_prefix, &format!("antagonist-{}", i), child.id());
+        if let Some(ref path) = placed {
+            if let Some(watch) = ThrottleWatch::new(path) {
+                watches.push(watch);
+            }
+        }
+        cgroups_ok &= placed.is_some();
+        children.push(child);
+    }
+
+    if !cgroups_ok {
+        tracing::warn!(
+            "cgroup placement failed (need root + cgroup v2); \
+             throttle-path timings will not be measured"
+        );
+    }
+
+    // Poll the antagonist cgroups for penalty writes while running
+    let start = Instant::now();
+    let deadline = start + Duration::from_secs(args.duration);
+    while Instant::now() < deadline {
+        for watch in &mut watches {
+            watch.poll(start.elapsed());
+        }
+        std::thread::sleep(Duration::from_millis(10));
+    }
+
+    for mut child in children {
+        let _ = child.wait();
+    }
+
+    // Aggregate victim results
+    tracing::info!("\n=== Victim latency ===");
+    for i in 0..args.victims {
+        let path = format!("{}/victim-{}.txt", args.results_dir, i);
+        match std::fs::read_to_string(&path) {
+            Ok(result) => tracing::info!("victim {}: {}", i, result.trim()),
+            Err(e) => tracing::warn!("victim {}: no results ({})", i, e),
+        }
+    }
+
+    // Penalty path end-to-end timings
+    tracing::info!("\n=== Throttle path ===");
+    if watches.is_empty() {
+        tracing::info!("(not measured - no watchable cgroups)");
+    }
+    for (i, watch) in watches.iter().enumerate() {
+        match (watch.throttled_at, watch.recovered_at) {
+            (Some(t), Some(r)) => tracing::info!(
+                "antagonist {}: time-to-throttle {:?}, time-to-recover {:?}",
+                i,
+                t,
+                r - t
+            ),
+            (Some(t), None) => tracing::info!(
+                "antagonist {}: time-to-throttle {:?}, not recovered before end",
+                i,
+                t
+            ),
+            (None, _) => tracing::info!(
+                "antagonist {}: never throttled (observer mode, or escalation \
+                 conditions unmet)",
+                i
+            ),
+        }
+    }
+
+    // Clean up cgroup directories (processes have exited)
+    for i in 0..args.victims {
+        let _ = std::fs::remove_dir(format!(
+            "{}/{}-victim-{}",
+            CGROUP_ROOT, args.cgroup_prefix, i
+        ));
+    }
+    for i in 0..args.antagonists {
+        let _ = std::fs::remove_dir(format!(
+            "{}/{}-antagonist-{}",
+            CGROUP_ROOT, args.cgroup_prefix, i
+        ));
+    }
+}
+
+/// Keeps a benchmark process registered with the scheduler for its run
+///
+/// The throttle path only fires for registered workers: morpheus_tick
+/// escalates a worker whose SCB says escapable + CGROUP_THROTTLE and
+/// whose requests go unacknowledged. Without this, antagonists are
+/// invisible to the scheduler and ThrottleWatch can never trigger.
+/// Degrades to None when the pinned maps are absent (no scheduler).
+struct SchedulerRegistration {
+    maps: BpfMaps,
+    tid: u32,
+    scb: Arc<ScbHandle>,
+}
+
+impl SchedulerRegistration {
+    fn try_new(pin_dir: &str, worker_id: u32, policy: EscalationPolicy) -> Option<Self> {
+        let maps = BpfMaps::from_pinned_paths(
+            &format!("{}/worker_tid_map", pin_dir),
+            &format!("{}/scb_map", pin_dir),
+        )
+        .ok()?;
+
+        let scb = unsafe { ScbHandle::new(maps.scb_map_fd(), worker_id, true) }
+            .map(Arc::new)
+            .ok()?;
+        scb.scb()
+            .escalation_policy
+            .store(policy as u32, Ordering::Release);
+
+        let tid = morpheus_runtime::worker::get_tid();
+        maps.register_worker(tid, worker_id).ok()?;
+
+        // Only a successfully registered worker advertises RUNNING;
+        // a failed attempt must not leave a live-looking orphan slot.
+        scb.scb()
+            .worker_state
+            .store(WorkerState::Running as u32, Ordering::Release);
+        morpheus_runtime::worker::set_current_scb(scb.clone(), worker_id);
+
+        tracing::info!(
+            "registered with scheduler as worker {} (policy {:?})",
+            worker_id,
+            policy
+        );
+        Some(Self { maps, tid, scb })
+    }
+}
+
+impl Drop for SchedulerRegistration {
+    fn drop(&mut self) {
+        self.scb
+            .scb()
+            .worker_state
+            .store(WorkerState::Dead as u32, Ordering::Release);
+        morpheus_runtime::worker::clear_current_scb();
+        let _ = self.maps.unregister_worker(self.tid);
+    }
+}
+
+/// Victim: a latency-measuring worker loop with checkpoints, reporting
+/// its distribution to the results dir for the driver to aggregate.
+fn victim(args: &Args) {
+    // Registered victims receive real hints, so their checkpoints (and
+    // the yields counter) reflect the scheduler, not a stub.
+    let _registration = SchedulerRegistration::try_new(
+        &args.pin_dir,
+        VICTIM_WORKER_BASE + args.index as u32,
+        EscalationPolicy::None,
+    );
+
+    let mut latencies_us: Vec<u64> = Vec::with_capacity(1 << 20);
+    let deadline = Instant::now() + Duration::from_secs(args.duration);
+    let mut yields = 0u64;
+
+    while Instant::now() < deadline {
+        let start = Instant::now();
+        let mut sum = 0u64;
+        for j in 0..1000u64 {
+            sum = sum.wrapping_add(j);
+        }
+        std::hint::black_box(sum);
+
+        if morpheus_runtime::checkpoint_sync() {
+            yields += 1;
+            std::thread::yield_now();
+            // Acknowledge, or the pending request stays set forever:
+            // every later checkpoint would count as a "yield" and the
+            // permanently-unacked SCB would drag down the ack ratio the
+            // slice controller tunes from.
+            if let Some(scb) = morpheus_runtime::worker::try_current_scb() {
+                scb.acknowledge();
+            }
+        }
+
+        latencies_us.push(start.elapsed().as_micros() as u64);
+        std::thread::sleep(Duration::from_micros(100));
+    }
+
+    latencies_us.sort_unstable();
+    let pct = |p: f64| -> u64 {
+        if latencies_us.is_empty() {
+            return 0;
+        }
+        let idx = ((latencies_us.len() as f64 * p / 100.0) as usize)
+            .min(latencies_us.len() - 1);
+        latencies_us[idx]
+    };
+
+    let report = format!(
+        "ops={} p50={}us p99={}us p999={}us max={}us yields={}",
+        latencies_us.len(),
+        pct(50.0),
+        pct(99.0),
+        pct(99.9),
+        latencies_us.last().copied().unwrap_or(0),
+        yields
+    );
+
+    let path = format!("{}/victim-{}.txt", args.results_dir, args.index);
+    if let Ok(mut file) = std::fs::File::create(&path) {
+        let _ = writeln!(file, "{}", report);
+    }
+}
+
+/// Antagonist: CPU-bound burn in the configured pattern
+///
+/// Registers with CGROUP_THROTTLE and then deliberately never
+/// checkpoints: the scheduler's hints go unacknowledged, the grace
+/// period expires, and the escalation path must throttle this process's
+/// cgroup - which is exactly what the driver's ThrottleWatch measures.
+fn antagonist(args: &Args) {
+    let _registration = SchedulerRegistration::try_new(
+        &args.pin_dir,
+        ANTAGONIST_WORKER_BASE + args.index as u32,
+        EscalationPolicy::CgroupThrottle,
+    );
+    if _registration.is_none() {
+        tracing::info!("scheduler maps absent; running unregistered (throttle path unmeasurable)");
+    }
+
+    let deadline = Instant::now() + Duration::from_secs(args.duration);
+    let burst = Duration::from_millis(args.burst_ms);
+
+    match args.pattern.as_str() {
+        "bursty" => {
+            // Alternate full burn and sleep, one burst period each
+            while Instant::now() < deadline {
+                let burn_until = Instant::now() + burst;
+                while Instant::now() < burn_until {
+                    std::hint::black_box(burn_chunk());
+                }
+                std::thread::sleep(burst);
+            }
+        }
+        "liar" => {
+            // Cross-process liar: burn inside long critical sections so
+            // the kernel must route relief through cgroup throttling
+            // rather than kicks. Only meaningful when this process is
+            // registered with the scheduler, but harmless otherwise.
+            while Instant::now() < deadline {
+                let _guard = morpheus_runtime::critical_section();
+                let burn_until = Instant::now() + burst;
+                while Instant::now() < burn_until {
+                    std::hint::black_box(burn_chunk());
+                }
+            }
+        }
+        _ => {
+            // steady: uninterrupted burn
+            while Instant::now() < deadline {
+                std::hint::black_box(burn_chunk());
+            }
+        }
+    }
+}
+
+#[inline]
+fn burn_chunk() -> u64 {
+    let mut counter = 0u64;
+    for _ in 0..100_000 {
+        counter = counter.wrapping_add(1);
+    }
+    counter
+}
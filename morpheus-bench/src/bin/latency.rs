@@ -1,17 +1,38 @@
-//! Latency benchmark
+//! Latency benchmark and evaluation harness
 //!
 //! Measures scheduling latencies under various conditions to validate
 //! that kernel-guided cooperation improves tail latency.
+//!
+//! Beyond a single run, the binary is the evaluation harness behind the
+//! project's "deterministic tail latency" claim:
+//!
+//! - a log-linear histogram with 32 sub-buckets per power of two (~3%
+//!   relative error) reporting the full percentile spectrum p50→p999999
+//! - machine-readable output: `--json` writes the run (config +
+//!   percentiles + per-repeat samples), `--hgrm` writes the classic
+//!   HdrHistogram textual percentile distribution (plot-tool compatible)
+//! - `--sweep` drives a matrix over {workers, checkpoint interval};
+//!   scheduler-side parameters (mode, slice, grace) are applied between
+//!   cells via `--config-cmd`, a shell template run with
+//!   MORPHEUS_SWEEP_* variables exported, so the matrix can restart or
+//!   retune a live scx_morpheus
+//! - `--repeat` runs each configuration N times and reports mean ± 95%
+//!   confidence intervals per percentile; `--compare a.json b.json`
+//!   prints an A/B report from two saved runs
+//!
+//! The human-readable summary keeps the `p50: N µs` / `Ops/second: N`
+//! lines that scripts/validate_benchmarks.py parses.
 
 use clap::Parser;
 use morpheus_runtime::checkpoint_sync;
+use std::io::Write;
 use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::Arc;
 use std::thread;
 use std::time::{Duration, Instant};
 
-/// Latency distribution benchmark
-#[derive(Parser, Debug)]
+/// Latency distribution benchmark and sweep harness
+#[derive(Parser, Debug, Clone)]
 #[command(author, version, about)]
 struct Args {
     /// Duration to run the benchmark (seconds)
@@ -33,61 +54,160 @@ struct Args {
     /// Enable checkpoint calls
     #[arg(long)]
     with_checkpoints: bool,
+
+    /// Operations between checkpoints
+    #[arg(long, default_value_t = 1)]
+    checkpoint_interval: u64,
+
+    /// Repeat the measurement N times and report confidence intervals
+    #[arg(long, default_value_t = 1)]
+    repeat: u32,
+
+    /// Write machine-readable results as JSON to this path
+    #[arg(long)]
+    json: Option<String>,
+
+    /// Write an HdrHistogram-style percentile distribution to this path
+    #[arg(long)]
+    hgrm: Option<String>,
+
+    /// Run the sweep matrix instead of a single configuration
+    #[arg(long)]
+    sweep: bool,
+
+    /// Shell command run before each sweep cell with MORPHEUS_SWEEP_*
+    /// exported (use it to retune/restart the scheduler)
+    #[arg(long)]
+    config_cmd: Option<String>,
+
+    /// Compare two saved JSON results (paths: baseline, candidate)
+    #[arg(long, num_args = 2)]
+    compare: Option<Vec<String>>,
 }
 
+/// Percentiles reported everywhere, with display labels
+const PERCENTILES: [(&str, f64); 7] = [
+    ("p50", 50.0),
+    ("p90", 90.0),
+    ("p99", 99.0),
+    ("p999", 99.9),
+    ("p9999", 99.99),
+    ("p99999", 99.999),
+    ("p999999", 99.9999),
+];
+
+/// Sub-bucket bits per power of two (~3% relative error)
+const HIST_SUB_BITS: u32 = 5;
+const HIST_SUB: u32 = 1 << HIST_SUB_BITS;
+const HIST_MAJORS: u32 = 40; /* 2^40ns ~ 18 minutes */
+const HIST_BUCKETS: usize = (HIST_MAJORS * HIST_SUB) as usize;
+
+/// Log-linear latency histogram fine enough for p999999 reporting
 struct LatencyHistogram {
-    buckets: [AtomicU64; 32],
+    buckets: Vec<AtomicU64>,
+    count: AtomicU64,
+    max_ns: AtomicU64,
 }
 
 impl LatencyHistogram {
     fn new() -> Self {
         Self {
-            buckets: std::array::from_fn(|_| AtomicU64::new(0)),
+            buckets: (0..HIST_BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            count: AtomicU64::new(0),
+            max_ns: AtomicU64::new(0),
         }
     }
 
-    fn record(&self, latency_us: u64) {
-        // Bucket index: log2(latency_us + 1), clamped to 31
-        let bucket = (64 - (latency_us + 1).leading_zeros()).min(31) as usize;
-        self.buckets[bucket].fetch_add(1, Ordering::Relaxed);
+    fn index(value_ns: u64) -> usize {
+        let value = value_ns.max(1);
+        let major = (63 - value.leading_zeros()).min(HIST_MAJORS - 1);
+        let sub = ((value >> major.saturating_sub(HIST_SUB_BITS)) as u32) & (HIST_SUB - 1);
+        ((major * HIST_SUB) + sub) as usize
+    }
+
+    fn bound_ns(index: usize) -> u64 {
+        let major = (index as u32) / HIST_SUB;
+        let sub = (index as u32) % HIST_SUB;
+        if major == 0 {
+            return (sub + 1) as u64;
+        }
+        (1u64 << major) + (((sub + 1) as u64) << major.saturating_sub(HIST_SUB_BITS))
     }
 
-    fn percentile(&self, p: f64) -> u64 {
-        let total: u64 = self.buckets.iter().map(|b| b.load(Ordering::Relaxed)).sum();
+    fn record(&self, latency_ns: u64) {
+        self.buckets[Self::index(latency_ns)].fetch_add(1, Ordering::Relaxed);
+        self.count.fetch_add(1, Ordering::Relaxed);
+        self.max_ns.fetch_max(latency_ns, Ordering::Relaxed);
+    }
 
-        let target = (total as f64 * p / 100.0) as u64;
-        let mut count = 0u64;
+    fn count(&self) -> u64 {
+        self.count.load(Ordering::Relaxed)
+    }
 
-        for (i, bucket) in self.buckets.iter().enumerate() {
-            count += bucket.load(Ordering::Relaxed);
-            if count >= target {
-                return 1u64 << i;
+    fn percentile_ns(&self, p: f64) -> u64 {
+        let total = self.count();
+        if total == 0 {
+            return 0;
+        }
+        let target = ((total as f64) * p / 100.0).ceil().max(1.0) as u64;
+        let mut seen = 0u64;
+        for (index, bucket) in self.buckets.iter().enumerate() {
+            seen += bucket.load(Ordering::Relaxed);
+            if seen >= target {
+                return Self::bound_ns(index);
             }
         }
-
-        1 << 31
+        self.max_ns.load(Ordering::Relaxed)
     }
 
-    #[allow(dead_code)]
-    fn total(&self) -> u64 {
-        self.buckets.iter().map(|b| b.load(Ordering::Relaxed)).sum()
+    /// Write the classic HdrHistogram textual percentile distribution
+    fn write_hgrm(&self, path: &str) -> std::io::Result<()> {
+        let mut file = std::fs::File::create(path)?;
+        writeln!(
+            file,
+            "{:>12} {:>14} {:>10} {:>14}\n",
+            "Value(us)", "Percentile", "TotalCount", "1/(1-Percentile)"
+        )?;
+
+        let total = self.count().max(1);
+        let mut seen = 0u64;
+        for (index, bucket) in self.buckets.iter().enumerate() {
+            let n = bucket.load(Ordering::Relaxed);
+            if n == 0 {
+                continue;
+            }
+            seen += n;
+            let pct = seen as f64 / total as f64;
+            let inv = if pct < 1.0 {
+                1.0 / (1.0 - pct)
+            } else {
+                f64::INFINITY
+            };
+            writeln!(
+                file,
+                "{:>12.3} {:>14.6} {:>10} {:>14.2}",
+                Self::bound_ns(index) as f64 / 1000.0,
+                pct,
+                seen,
+                inv
+            )?;
+        }
+        writeln!(file, "#[Mean percentile distribution, {} samples]", total)?;
+        Ok(())
     }
 }
 
-fn main() {
-    let args = Args::parse();
-
-    tracing_subscriber::fmt().with_env_filter("info").init();
-
-    tracing::info!("Latency benchmark");
-    tracing::info!("  Duration: {}s", args.duration);
-    tracing::info!("  Workers: {}", args.workers);
-    tracing::info!("  Target ops/s per worker: {}", args.ops_per_second);
-    tracing::info!("  Pressure simulation: {}", args.pressure);
-    tracing::info!("  Checkpoints enabled: {}", args.with_checkpoints);
+/// Results of one measurement run
+#[derive(Clone)]
+struct RunResult {
+    percentiles_ns: Vec<(String, u64)>,
+    ops_per_sec: f64,
+    yields: u64,
+}
 
+/// Run one measurement with the given configuration
+fn run_once(args: &Args, histogram: &Arc<LatencyHistogram>) -> RunResult {
     let stop = Arc::new(AtomicBool::new(false));
-    let histogram = Arc::new(LatencyHistogram::new());
     let total_ops = Arc::new(AtomicU64::new(0));
     let checkpoint_yields = Arc::new(AtomicU64::new(0));
 
@@ -110,11 +230,10 @@ fn main() {
                 .unwrap();
             pressure_handles.push(handle);
         }
-        tracing::info!("Started {} pressure threads", args.workers);
     }
 
     // Spawn latency worker threads
-    let interval = Duration::from_nanos(1_000_000_000 / args.ops_per_second);
+    let interval = Duration::from_nanos(1_000_000_000 / args.ops_per_second.max(1));
     let mut worker_handles = Vec::new();
 
     for i in 0..args.workers {
@@ -123,11 +242,13 @@ fn main() {
         let ops_clone = total_ops.clone();
         let yields_clone = checkpoint_yields.clone();
         let with_checkpoints = args.with_checkpoints;
+        let checkpoint_interval = args.checkpoint_interval.max(1);
 
         let handle = thread::Builder::new()
             .name(format!("worker-{}", i))
             .spawn(move || {
                 let mut last_op = Instant::now();
+                let mut since_checkpoint = 0u64;
 
                 while !stop_clone.load(Ordering::Relaxed) {
                     let start = Instant::now();
@@ -139,14 +260,20 @@ fn main() {
                     }
                     std::hint::black_box(sum);
 
-                    // Checkpoint if enabled
-                    if with_checkpoints && checkpoint_sync() {
-                        yields_clone.fetch_add(1, Ordering::Relaxed);
-                        thread::yield_now();
+                    // Checkpoint every checkpoint_interval operations
+                    if with_checkpoints {
+                        since_checkpoint += 1;
+                        if since_checkpoint >= checkpoint_interval {
+                            since_checkpoint = 0;
+                            if checkpoint_sync() {
+                                yields_clone.fetch_add(1, Ordering::Relaxed);
+                                thread::yield_now();
+                            }
+                        }
                     }
 
                     let elapsed = start.elapsed();
-                    hist_clone.record(elapsed.as_micros() as u64);
+                    hist_clone.record(elapsed.as_nanos() as u64);
                     ops_clone.fetch_add(1, Ordering::Relaxed);
 
                     // Rate limiting
@@ -162,11 +289,7 @@ fn main() {
         worker_handles.push(handle);
     }
 
-    // Run benchmark
-    tracing::info!("Running for {} seconds...", args.duration);
     thread::sleep(Duration::from_secs(args.duration));
-
-    // Stop all threads
     stop.store(true, Ordering::Release);
 
     for handle in pressure_handles {
@@ -176,35 +299,270 @@ fn main() {
         handle.join().unwrap();
     }
 
-    // Report results
-    let total = total_ops.load(Ordering::Relaxed);
-    let p50 = histogram.percentile(50.0);
-    let p95 = histogram.percentile(95.0);
-    let p99 = histogram.percentile(99.0);
-    let p999 = histogram.percentile(99.9);
-    let yields = checkpoint_yields.load(Ordering::Relaxed);
+    let percentiles_ns = PERCENTILES
+        .iter()
+        .map(|(label, p)| (label.to_string(), histogram.percentile_ns(*p)))
+        .collect();
+
+    RunResult {
+        percentiles_ns,
+        ops_per_sec: total_ops.load(Ordering::Relaxed) as f64 / args.duration as f64,
+        yields: checkpoint_yields.load(Ordering::Relaxed),
+    }
+}
+
+/// Mean and 95% confidence half-interval of a sample set
+fn mean_ci(samples: &[f64]) -> (f64, f64) {
+    let n = samples.len() as f64;
+    let mean = samples.iter().sum::<f64>() / n;
+    if samples.len() < 2 {
+        return (mean, 0.0);
+    }
+    let var = samples.iter().map(|s| (s - mean).powi(2)).sum::<f64>() / (n - 1.0);
+    // 1.96 * standard error: fine for reporting at these repeat counts
+    (mean, 1.96 * (var / n).sqrt())
+}
+
+/// Hand-rolled JSON writer (no serde dependency in this crate)
+fn write_json(path: &str, args: &Args, runs: &[RunResult]) -> std::io::Result<()> {
+    let mut out = String::new();
+    out.push_str("{\n");
+    out.push_str(&format!(
+        "  \"config\": {{\"duration_s\": {}, \"workers\": {}, \"ops_per_second\": {}, \"pressure\": {}, \"with_checkpoints\": {}, \"checkpoint_interval\": {}}},\n",
+        args.duration, args.workers, args.ops_per_second, args.pressure,
+        args.with_checkpoints, args.checkpoint_interval
+    ));
+    out.push_str("  \"runs\": [\n");
+    for (i, run) in runs.iter().enumerate() {
+        out.push_str("    {\"percentiles_ns\": {");
+        for (j, (label, value)) in run.percentiles_ns.iter().enumerate() {
+            if j > 0 {
+                out.push_str(", ");
+            }
+            out.push_str(&format!("\"{}\": {}", label, value));
+        }
+        out.push_str(&format!(
+            "}}, \"ops_per_sec\": {:.0}, \"yields\": {}}}{}\n",
+            run.ops_per_sec,
+            run.yields,
+            if i + 1 < runs.len() { "," } else { "" }
+        ));
+    }
+    out.push_str("  ],\n");
+
+    // Aggregate mean +- 95% CI per percentile across repeats
+    out.push_str("  \"summary\": {");
+    for (i, (label, _)) in PERCENTILES.iter().enumerate() {
+        let samples: Vec<f64> = runs.iter().map(|r| r.percentiles_ns[i].1 as f64).collect();
+        let (mean, ci) = mean_ci(&samples);
+        if i > 0 {
+            out.push_str(", ");
+        }
+        out.push_str(&format!(
+            "\"{}\": {{\"mean_ns\": {:.0}, \"ci95_ns\": {:.0}}}",
+            label, mean, ci
+        ));
+    }
+    out.push_str("}\n}\n");
+
+    std::fs::write(path, out)
+}
+
+/// A/B report from two saved JSON files
+fn compare(baseline_path: &str, candidate_path: &str) {
+    let parse = |path: &str| -> Vec<(String, f64, f64)> {
+        let text = std::fs::read_to_string(path).unwrap_or_else(|e| {
+            eprintln!("failed to read {}: {}", path, e);
+            std::process::exit(1);
+        });
+        PERCENTILES
+            .iter()
+            .filter_map(|(label, _)| {
+                let key = format!("\"{}\": {{\"mean_ns\": ", label);
+                let start = text.find(&key)? + key.len();
+                let rest = &text[start..];
+                let mean: f64 = rest[..rest.find(',')?].trim().parse().ok()?;
+                let ci_key = "\"ci95_ns\": ";
+                let ci_start = rest.find(ci_key)? + ci_key.len();
+                let ci_rest = &rest[ci_start..];
+                let ci: f64 = ci_rest[..ci_rest.find('}')?].trim().parse().ok()?;
+                Some((label.to_string(), mean, ci))
+            })
+            .collect()
+    };
+
+    let baseline = parse(baseline_path);
+    let candidate = parse(candidate_path);
+
+    println!("A/B report: {} -> {}", baseline_path, candidate_path);
+    println!(
+        "{:>10} {:>14} {:>14} {:>10}  significant?",
+        "pctl", "baseline(us)", "candidate(us)", "delta"
+    );
+    for ((label, b_mean, b_ci), (_, c_mean, c_ci)) in baseline.iter().zip(candidate.iter()) {
+        let delta_pct = if *b_mean > 0.0 {
+            (c_mean - b_mean) / b_mean * 100.0
+        } else {
+            0.0
+        };
+        // Non-overlapping 95% CIs = significant at this reporting level
+        let significant = (c_mean - b_mean).abs() > b_ci + c_ci;
+        println!(
+            "{:>10} {:>14.1} {:>14.1} {:>+9.1}%  {}",
+            label,
+            b_mean / 1000.0,
+            c_mean / 1000.0,
+            delta_pct,
+            if significant { "yes" } else { "no" }
+        );
+    }
+}
+
+/// The sweep matrix over runtime-side parameters
+///
+/// Scheduler-side parameters (mode, slice, grace) are the loader's to
+/// change; --config-cmd runs between cells with the cell exported in
+/// MORPHEUS_SWEEP_* so an operator script can restart or retune
+/// scx_morpheus per cell.
+fn sweep(args: &Args) {
+    let worker_counts = [1usize, 2, 4];
+    let checkpoint_intervals = [100u64, 1_000, 10_000];
+
+    for &workers in &worker_counts {
+        for &interval in &checkpoint_intervals {
+            let mut cell = args.clone();
+            cell.workers = workers;
+            cell.checkpoint_interval = interval;
+            cell.with_checkpoints = true;
+            cell.sweep = false;
+
+            if let Some(cmd) = &args.config_cmd {
+                let status = std::process::Command::new("sh")
+                    .arg("-c")
+                    .arg(cmd)
+                    .env("MORPHEUS_SWEEP_WORKERS", workers.to_string())
+                    .env("MORPHEUS_SWEEP_CHECKPOINT_INTERVAL", interval.to_string())
+                    .status();
+                if let Err(e) = status {
+                    tracing::warn!("config-cmd failed: {}", e);
+                }
+            }
+
+            tracing::info!(
+                "=== sweep cell: workers={} checkpoint_interval={} ===",
+                workers,
+                interval
+            );
+            let mut histogram = Arc::new(LatencyHistogram::new());
+            let mut runs = Vec::new();
+            for _ in 0..args.repeat.max(1) {
+                // Fresh histogram per repeat: percentile samples must be
+                // independent for the confidence intervals to mean anything
+                histogram = Arc::new(LatencyHistogram::new());
+                runs.push(run_once(&cell, &histogram));
+            }
+            report(&cell, &histogram, &runs);
+
+            if let Some(base) = &args.json {
+                let path = format!("{}.w{}.i{}.json", base, workers, interval);
+                if let Err(e) = write_json(&path, &cell, &runs) {
+                    tracing::warn!("failed to write {}: {}", path, e);
+                }
+            }
+        }
+    }
+}
+
+/// Human-readable report (keeps the format validate_benchmarks.py parses)
+///
+/// The distribution section shows the final repeat's histogram; the
+/// cross-repeat section aggregates per-run percentiles.
+fn report(args: &Args, histogram: &Arc<LatencyHistogram>, runs: &[RunResult]) {
+    let last = runs.last().expect("at least one run");
 
     tracing::info!("\n=== Results ===");
-    tracing::info!("Total operations: {}", total);
-    tracing::info!("Ops/second: {:.0}", total as f64 / args.duration as f64);
-    tracing::info!("Checkpoint yields: {}", yields);
+    tracing::info!("Ops/second: {:.0}", last.ops_per_sec);
+    tracing::info!("Checkpoint yields: {}", last.yields);
     tracing::info!("");
     tracing::info!("Latency distribution:");
-    tracing::info!("  p50:  {} µs", p50);
-    tracing::info!("  p95:  {} µs", p95);
-    tracing::info!("  p99:  {} µs", p99);
-    tracing::info!("  p99.9: {} µs", p999);
+    for (label, p) in PERCENTILES {
+        tracing::info!("  {}:  {} µs", label, histogram.percentile_ns(p) / 1000);
+    }
+    // Compatibility alias for older tooling
+    tracing::info!("  p95:  {} µs", histogram.percentile_ns(95.0) / 1000);
+
+    if runs.len() > 1 {
+        tracing::info!("");
+        tracing::info!("Across {} repeats (mean ± 95% CI):", runs.len());
+        for (i, (label, _)) in PERCENTILES.iter().enumerate() {
+            let samples: Vec<f64> = runs.iter().map(|r| r.percentiles_ns[i].1 as f64).collect();
+            let (mean, ci) = mean_ci(&samples);
+            tracing::info!("  {}: {:.1} ± {:.1} µs", label, mean / 1000.0, ci / 1000.0);
+        }
+    }
 
-    // Validation
-    if p99 > 1000 {
+    if last.percentiles_ns[2].1 > 1_000_000 {
         tracing::warn!("p99 latency > 1ms - may indicate scheduling issues");
     }
-
-    if args.with_checkpoints && yields == 0 && args.pressure {
+    if args.with_checkpoints && last.yields == 0 && args.pressure {
         tracing::warn!(
             "No checkpoint yields despite pressure - kernel hints may not be reaching userspace"
         );
     }
+}
+
+fn main() {
+    let args = Args::parse();
+
+    tracing_subscriber::fmt().with_env_filter("info").init();
+
+    if let Some(paths) = &args.compare {
+        compare(&paths[0], &paths[1]);
+        return;
+    }
+
+    if args.sweep {
+        sweep(&args);
+        return;
+    }
+
+    tracing::info!("Latency benchmark");
+    tracing::info!("  Duration: {}s x {} repeat(s)", args.duration, args.repeat);
+    tracing::info!("  Workers: {}", args.workers);
+    tracing::info!("  Target ops/s per worker: {}", args.ops_per_second);
+    tracing::info!("  Pressure simulation: {}", args.pressure);
+    tracing::info!(
+        "  Checkpoints: {} (every {} ops)",
+        args.with_checkpoints,
+        args.checkpoint_interval
+    );
+
+    let mut histogram = Arc::new(LatencyHistogram::new());
+    let mut runs = Vec::new();
+    for run in 0..args.repeat.max(1) {
+        if args.repeat > 1 {
+            tracing::info!("--- repeat {}/{} ---", run + 1, args.repeat);
+        }
+        // Fresh histogram per repeat: percentile samples must be
+        // independent for the confidence intervals to mean anything
+        histogram = Arc::new(LatencyHistogram::new());
+        runs.push(run_once(&args, &histogram));
+    }
+
+    report(&args, &histogram, &runs);
+
+    if let Some(path) = &args.json {
+        match write_json(path, &args, &runs) {
+            Ok(()) => tracing::info!("JSON results written to {}", path),
+            Err(e) => tracing::error!("failed to write {}: {}", path, e),
+        }
+    }
+    if let Some(path) = &args.hgrm {
+        match histogram.write_hgrm(path) {
+            Ok(()) => tracing::info!("HDR percentile distribution written to {}", path),
+            Err(e) => tracing::error!("failed to write {}: {}", path, e),
+        }
+    }
 
     tracing::info!("\nBenchmark complete");
 }
@@ -55,17 +55,22 @@ typedef int64_t  __s64;
  * ============================================================================
  *
  * State transitions: INIT → REGISTERED → RUNNING → QUIESCING → DEAD
+ *                                          ↕
+ *                                        PARKED (idle, elastic pool)
  *
  * Rules:
  * - Kernel emits hints only when state == RUNNING
- * - Escalation forbidden in INIT or QUIESCING
+ * - Escalation forbidden in INIT, QUIESCING, or PARKED
  * - Cleanup triggered only from DEAD
+ * - PARKED workers are blocked in the runtime awaiting work; they
+ *   consume no CPU and receive no hints until unparked
  */
 #define MORPHEUS_WORKER_STATE_INIT       0
 #define MORPHEUS_WORKER_STATE_REGISTERED 1
 #define MORPHEUS_WORKER_STATE_RUNNING    2
 #define MORPHEUS_WORKER_STATE_QUIESCING  3
 #define MORPHEUS_WORKER_STATE_DEAD       4
+#define MORPHEUS_WORKER_STATE_PARKED     5
 
 /*
  * ============================================================================
@@ -100,38 +105,40 @@ typedef int64_t  __s64;
 
 /*
  * ============================================================================
- * Shared Control Block (SCB) - One per worker thread
+ * Shared Control Block (SCB) v2 - One per worker thread
  * ============================================================================
  *
  * Memory layout is critical: 64-byte aligned for cache efficiency.
  * All fields are atomically accessed; no locks required.
  *
- * Split into two cache lines:
- *   - Line 1 (bytes 0-63): Kernel → Runtime fields
- *   - Line 2 (bytes 64-127): Runtime → Kernel fields
+ * Three cache lines, segregated by access pattern:
+ *   - Line 1 (bytes 0-63):    Kernel → Runtime, checkpoint-critical.
+ *     Only fields the runtime reads on every checkpoint, written by the
+ *     kernel only when it actually wants something. Nothing here is
+ *     touched by routine kernel bookkeeping, so the worker's cached
+ *     copy stays valid between yield requests.
+ *   - Line 2 (bytes 64-127):  Runtime → Kernel fields.
+ *   - Line 3 (bytes 128-191): Kernel-maintained stats and budget,
+ *     written on deschedule/overflow at times unrelated to checkpoints.
+ *     In the v1 layout these shared line 1 with preempt_seq, so every
+ *     budget update invalidated the line the next checkpoint had to
+ *     re-read.
+ *
+ * The version field lets both sides negotiate layout: whoever
+ * initializes a slot first stamps MORPHEUS_SCB_VERSION, and the other
+ * side refuses a nonzero mismatch.
  */
-struct morpheus_scb {
-    /* === Cache Line 1: Kernel → Runtime === */
-
-    /*
-     * Monotonically increasing sequence number. Kernel increments this
-     * when it wants the runtime to yield. Runtime compares against
-     * last_ack_seq to detect pending yield requests.
-     */
-    __u64 preempt_seq;
+#define MORPHEUS_SCB_VERSION 2
 
-    /*
-     * Remaining time budget in nanoseconds. Advisory only; kernel
-     * updates this on each tick. Runtime may use for soft budgeting.
-     */
-    __u64 budget_remaining_ns;
+struct morpheus_scb {
+    /* === Cache Line 1: Kernel → Runtime (checkpoint-critical) === */
 
     /*
-     * System pressure level (0-100). Kernel sets this based on
-     * runqueue depth, CPU utilization, and memory pressure.
-     * 0 = no pressure, 100 = critical.
+     * Layout version (MORPHEUS_SCB_VERSION). Stamped by whichever side
+     * initializes the slot first; a nonzero mismatch means the peer
+     * speaks a different layout and must not attach.
      */
-    __u32 kernel_pressure_level;
+    __u32 version;
 
     /*
      * Worker lifecycle state (one of MORPHEUS_WORKER_STATE_*).
@@ -140,22 +147,31 @@ struct morpheus_scb {
     __u32 worker_state;
 
     /*
-     * Count of hints that were dropped/lost (ring buffer overflow).
-     * Kernel increments this when it fails to emit a hint.
+     * Monotonically increasing sequence number. Kernel increments this
+     * when it wants the runtime to yield. Runtime compares against
+     * last_ack_seq to detect pending yield requests.
      */
-    __u32 hint_loss_count;
+    __u64 preempt_seq;
 
     /*
-     * Timestamp (ns) of last escalation event against this worker.
+     * System pressure level (0-100). Kernel sets this based on
+     * runqueue depth, CPU utilization, and memory pressure.
+     * 0 = no pressure, 100 = critical.
      */
-    __u64 last_escalation_ns;
+    __u32 kernel_pressure_level;
 
     /*
-     * Count of ring buffer overflow events.
+     * Coalesced hint delivery: reason (MORPHEUS_HINT_*) and deadline of
+     * the most recent yield request. Written by the kernel BEFORE it
+     * bumps preempt_seq, so a runtime that observes a new preempt_seq is
+     * guaranteed to see matching values here. Level-triggered and
+     * overflow-proof, unlike the ring buffer (which remains as a sampled
+     * observability stream).
      */
-    __u32 ringbuf_overflow_count;
+    __u32 pending_hint_reason;
+    __u64 pending_hint_deadline_ns;
 
-    __u32 _reserved0[5];
+    __u32 _reserved0[8];
 
     /* === Cache Line 2: Runtime → Kernel === */
 
@@ -193,7 +209,11 @@ struct morpheus_scb {
     __u32 last_yield_reason;
 
     /*
-     * Reservation token for future reservation protocol.
+     * Deadline reservation: absolute deadline (ns, CLOCK_MONOTONIC) of
+     * this worker's active reservation, or 0 for none. While set, the
+     * scheduler dispatches the worker EDF ahead of the ordinary shards
+     * and warns competing workers with MORPHEUS_HINT_DEADLINE as the
+     * deadline approaches.
      */
     __u64 reservation_token;
 
@@ -202,13 +222,47 @@ struct morpheus_scb {
      */
     __u32 escalation_policy;
 
-    __u32 _pad;
+    /*
+     * NUMA affinity hint: node id + 1, or 0 for no preference. The
+     * scheduler avoids migrating this worker off the preferred node
+     * unless its local runqueue shard is backed up.
+     */
+    __u32 preferred_node;
+
+    __u32 _reserved1[6];
+
+    /* === Cache Line 3: Kernel-maintained stats (off the checkpoint path) === */
+
+    /*
+     * Remaining time budget in nanoseconds. Advisory only; kernel
+     * updates this on each deschedule. Runtime may use for soft
+     * budgeting.
+     */
+    __u64 budget_remaining_ns;
+
+    /*
+     * Timestamp (ns) of last escalation event against this worker.
+     */
+    __u64 last_escalation_ns;
+
+    /*
+     * Count of hints that were dropped/lost (ring buffer overflow).
+     * Kernel increments this when it fails to emit a hint.
+     */
+    __u32 hint_loss_count;
+
+    /*
+     * Count of ring buffer overflow events.
+     */
+    __u32 ringbuf_overflow_count;
+
+    __u32 _reserved2[10];
 
 } __attribute__((aligned(64)));
 
 /* Compile-time size check */
-_Static_assert(sizeof(struct morpheus_scb) == 128,
-               "morpheus_scb must be exactly 128 bytes (2 cache lines)");
+_Static_assert(sizeof(struct morpheus_scb) == 192,
+               "morpheus_scb must be exactly 192 bytes (3 cache lines)");
 
 /*
  * ============================================================================
@@ -253,6 +307,41 @@ struct morpheus_hint {
 
     /* Deadline in nanoseconds (monotonic). Kernel may escalate after this. */
     __u64 deadline_ns;
+
+    /*
+     * Emission timestamp (ns, CLOCK_MONOTONIC). Lets the consumer and
+     * the acking worker assemble per-hint latency spans: emit->receive
+     * (ring buffer + wakeup) and receive->ack (delivery + response).
+     */
+    __u64 emit_ns;
+};
+
+/*
+ * ============================================================================
+ * Syscall-free registration region
+ * ============================================================================
+ *
+ * One slot per worker, indexed by worker_id, in a BPF_F_MMAPABLE array
+ * the runtime maps once. Worker spawn/teardown become plain memory
+ * stores: the runtime fills tid/worker_id and flips the slot state; the
+ * kernel-side timer sweeps the region, mirrors membership into
+ * worker_tid_map, and bumps the registration generation itself. No
+ * bpf() syscalls on the worker spawn path.
+ *
+ * Slot state machine (single writer per field):
+ *   FREE -> CLAIMED (runtime)  -> ACTIVE (kernel)
+ *   ACTIVE -> RELEASING (runtime) -> FREE (kernel)
+ */
+#define MORPHEUS_REG_SLOT_FREE      0
+#define MORPHEUS_REG_SLOT_CLAIMED   1
+#define MORPHEUS_REG_SLOT_ACTIVE    2
+#define MORPHEUS_REG_SLOT_RELEASING 3
+
+struct morpheus_reg_slot {
+    __u32 state;     /* MORPHEUS_REG_SLOT_* */
+    __u32 tid;       /* OS thread id */
+    __u32 worker_id; /* redundant with the slot index, kept for debugging */
+    __u32 _pad;
 };
 
 /*
@@ -271,6 +360,8 @@ struct morpheus_hint {
 #define MORPHEUS_SCB_MAP_NAME           "scb_map"
 #define MORPHEUS_HINT_RINGBUF_NAME      "hint_ringbuf"
 #define MORPHEUS_WORKER_MAP_NAME        "worker_tid_map"
+#define MORPHEUS_REG_GEN_MAP_NAME       "reg_gen_map"
+#define MORPHEUS_REG_REGION_MAP_NAME    "reg_region_map"
 #define MORPHEUS_GLOBAL_PRESSURE_NAME   "global_pressure_map"
 #define MORPHEUS_CONFIG_MAP_NAME        "config_map"
 
@@ -12,7 +12,7 @@
 //!
 //! - **Language-neutral**: Operates at worker-thread level, not async task level
 //! - **No pointers cross boundary**: SCB contains only integers
-//! - **Cache-aligned**: SCB is 128 bytes (2 cache lines) for optimal performance
+//! - **Cache-aligned**: SCB is 192 bytes (3 cache lines) for optimal performance
 //!
 //! ## Architectural Guardrails (Non-Goals)
 //!
@@ -55,13 +55,14 @@ pub enum SchedulerMode {
 /// State transitions:
 /// ```text
 /// INIT → REGISTERED → RUNNING → QUIESCING → DEAD
-///                       ↑          ↓
+///                       ↑  ↕       ↓
+///                       │ PARKED   │ (elastic pool idle)
 ///                       └──────────┘ (recovery)
 /// ```
 ///
 /// Rules:
 /// - Kernel emits hints only when state == RUNNING
-/// - Escalation forbidden in INIT or QUIESCING
+/// - Escalation forbidden in INIT, QUIESCING, or PARKED
 /// - Cleanup triggered only from DEAD
 #[repr(u32)]
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
@@ -81,6 +82,9 @@ pub enum WorkerState {
 
     /// Worker terminated, ready for cleanup
     Dead = 4,
+
+    /// Worker idle and blocked awaiting work (elastic pool); no hints
+    Parked = 5,
 }
 
 impl WorkerState {
@@ -107,6 +111,7 @@ impl TryFrom<u32> for WorkerState {
             2 => Ok(WorkerState::Running),
             3 => Ok(WorkerState::Quiescing),
             4 => Ok(WorkerState::Dead),
+            5 => Ok(WorkerState::Parked),
             _ => Err(()),
         }
     }
@@ -268,16 +273,24 @@ impl TryFrom<u32> for HintReason {
 // Shared Control Block (SCB) - Extended
 // ============================================================================
 
-/// Shared Control Block (SCB) - One per worker thread
+/// Shared Control Block (SCB) v2 - One per worker thread
 ///
 /// This is the primary communication structure between the kernel scheduler
 /// and userspace runtimes. Each worker thread owns exactly one SCB.
 ///
 /// # Memory Layout
 ///
-/// The SCB is split into two 64-byte cache lines:
-/// - **Line 1 (bytes 0-63)**: Kernel → Runtime fields (read by runtime)
-/// - **Line 2 (bytes 64-127)**: Runtime → Kernel fields (written by runtime)
+/// Three 64-byte cache lines, segregated by access pattern:
+/// - **Line 1 (bytes 0-63)**: Kernel → Runtime, checkpoint-critical.
+///   Written by the kernel only when it wants something, so the worker's
+///   cached copy stays valid between yield requests.
+/// - **Line 2 (bytes 64-127)**: Runtime → Kernel fields.
+/// - **Line 3 (bytes 128-191)**: Kernel-maintained stats and budget,
+///   written at times unrelated to checkpoints.
+///
+/// The `version` field (see [`config::SCB_VERSION`]) lets both sides
+/// negotiate layout: whoever initializes a slot first stamps it, and
+/// the other side refuses a nonzero mismatch.
 ///
 /// # Thread Safety
 ///
@@ -286,31 +299,30 @@ impl TryFrom<u32> for HintReason {
 #[repr(C, align(64))]
 #[derive(Debug)]
 pub struct MorpheusScb {
-    // === Cache Line 1: Kernel → Runtime ===
+    // === Cache Line 1: Kernel → Runtime (checkpoint-critical) ===
+    /// Layout version (config::SCB_VERSION); nonzero mismatch = refuse
+    pub version: AtomicU32,
+
+    /// Worker lifecycle state (WorkerState enum)
+    pub worker_state: AtomicU32,
+
     /// Monotonically increasing sequence number.
     /// Kernel increments when yield is requested.
     pub preempt_seq: AtomicU64,
 
-    /// Remaining time budget in nanoseconds (advisory).
-    pub budget_remaining_ns: AtomicU64,
-
     /// System pressure level (0-100).
     pub kernel_pressure_level: AtomicU32,
 
-    /// Worker lifecycle state (WorkerState enum)
-    pub worker_state: AtomicU32,
-
-    /// Count of hints that were dropped/lost (ring buffer overflow)
-    pub hint_loss_count: AtomicU32,
-
-    /// Timestamp (ns) of last escalation event against this worker
-    pub last_escalation_ns: AtomicU64,
+    /// Coalesced hint delivery: reason (HintReason) of the most recent
+    /// yield request. Written by the kernel before bumping preempt_seq.
+    pub pending_hint_reason: AtomicU32,
 
-    /// Count of ring buffer overflow events
-    pub ringbuf_overflow_count: AtomicU32,
+    /// Coalesced hint delivery: deadline (ns, monotonic) of the most
+    /// recent yield request.
+    pub pending_hint_deadline_ns: AtomicU64,
 
     /// Reserved for future use
-    _reserved0: [u32; 5],
+    _reserved0: [u32; 8],
 
     // === Cache Line 2: Runtime → Kernel ===
     /// 1 if in critical section (FFI, GIL-held, etc.).
@@ -329,19 +341,40 @@ pub struct MorpheusScb {
     /// Last yield reason (YieldReason enum) - for observability
     pub last_yield_reason: AtomicU32,
 
-    /// Reservation token for future reservation protocol
+    /// Deadline reservation: absolute deadline (ns, monotonic) of this
+    /// worker's active reservation, or 0 for none. Drives EDF dispatch.
     pub reservation_token: AtomicU64,
 
     /// Escalation policy for this worker
     pub escalation_policy: AtomicU32,
 
-    _pad: u32,
+    /// NUMA affinity hint: node id + 1, or 0 for no preference
+    pub preferred_node: AtomicU32,
+
+    /// Reserved for future use
+    _reserved1: [u32; 6],
+
+    // === Cache Line 3: Kernel-maintained stats (off the checkpoint path) ===
+    /// Remaining time budget in nanoseconds (advisory).
+    pub budget_remaining_ns: AtomicU64,
+
+    /// Timestamp (ns) of last escalation event against this worker
+    pub last_escalation_ns: AtomicU64,
+
+    /// Count of hints that were dropped/lost (ring buffer overflow)
+    pub hint_loss_count: AtomicU32,
+
+    /// Count of ring buffer overflow events
+    pub ringbuf_overflow_count: AtomicU32,
+
+    /// Reserved for future use
+    _reserved2: [u32; 10],
 }
 
 // Compile-time size assertion
 const _: () = assert!(
-    core::mem::size_of::<MorpheusScb>() == 128,
-    "MorpheusScb must be exactly 128 bytes"
+    core::mem::size_of::<MorpheusScb>() == 192,
+    "MorpheusScb must be exactly 192 bytes"
 );
 
 impl MorpheusScb {
@@ -353,14 +386,19 @@ impl MorpheusScb {
     ///   - Python workers: typically `false` (GIL safety)
     pub const fn new(escapable: bool) -> Self {
         Self {
+            version: AtomicU32::new(config::SCB_VERSION),
+            worker_state: AtomicU32::new(WorkerState::Init as u32),
             preempt_seq: AtomicU64::new(0),
-            budget_remaining_ns: AtomicU64::new(0),
             kernel_pressure_level: AtomicU32::new(0),
-            worker_state: AtomicU32::new(WorkerState::Init as u32),
+            pending_hint_reason: AtomicU32::new(0),
+            pending_hint_deadline_ns: AtomicU64::new(0),
+            _reserved0: [0; 8],
+            budget_remaining_ns: AtomicU64::new(0),
             hint_loss_count: AtomicU32::new(0),
             last_escalation_ns: AtomicU64::new(0),
             ringbuf_overflow_count: AtomicU32::new(0),
-            _reserved0: [0; 5],
+            _reserved1: [0; 6],
+            _reserved2: [0; 10],
             is_in_critical_section: AtomicU32::new(0),
             escapable: AtomicU32::new(if escapable { 1 } else { 0 }),
             last_ack_seq: AtomicU64::new(0),
@@ -368,7 +406,7 @@ impl MorpheusScb {
             last_yield_reason: AtomicU32::new(YieldReason::None as u32),
             reservation_token: AtomicU64::new(0),
             escalation_policy: AtomicU32::new(EscalationPolicy::None as u32),
-            _pad: 0,
+            preferred_node: AtomicU32::new(0),
         }
     }
 }
@@ -448,8 +486,79 @@ pub struct MorpheusHint {
 
     /// Deadline in nanoseconds (monotonic clock)
     pub deadline_ns: u64,
+
+    /// Emission timestamp (ns, CLOCK_MONOTONIC); 0 if unknown.
+    /// Used to assemble per-hint latency spans across delivery stages.
+    pub emit_ns: u64,
 }
 
+// ============================================================================
+// Syscall-free registration region
+// ============================================================================
+
+/// State of a registration slot (see `morpheus_reg_slot` in the C header)
+///
+/// Transitions:
+/// - `Free -> Claimed` (runtime) `-> Active` (kernel)
+/// - `Active -> Releasing` (runtime) `-> Free` (kernel)
+#[repr(u32)]
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum RegSlotState {
+    /// Slot unused
+    #[default]
+    Free = 0,
+
+    /// Runtime wrote tid/worker_id; awaiting kernel pickup
+    Claimed = 1,
+
+    /// Kernel mirrored the registration into worker_tid_map
+    Active = 2,
+
+    /// Runtime requested deregistration; awaiting kernel cleanup
+    Releasing = 3,
+}
+
+impl TryFrom<u32> for RegSlotState {
+    type Error = ();
+
+    fn try_from(value: u32) -> Result<Self, Self::Error> {
+        match value {
+            0 => Ok(RegSlotState::Free),
+            1 => Ok(RegSlotState::Claimed),
+            2 => Ok(RegSlotState::Active),
+            3 => Ok(RegSlotState::Releasing),
+            _ => Err(()),
+        }
+    }
+}
+
+/// One slot of the mmap'd registration region, indexed by worker_id.
+///
+/// Worker spawn/teardown are plain memory stores into this structure;
+/// the kernel-side timer sweeps the region and mirrors membership into
+/// its hash map. Each field has a single writer at any point in the
+/// state machine, so atomics suffice.
+#[repr(C)]
+#[derive(Debug)]
+pub struct MorpheusRegSlot {
+    /// Slot state (RegSlotState)
+    pub state: AtomicU32,
+
+    /// OS thread id of the registering worker
+    pub tid: AtomicU32,
+
+    /// Worker id (redundant with the slot index, kept for debugging)
+    pub worker_id: AtomicU32,
+
+    _pad: u32,
+}
+
+// Compile-time size assertion to match the C layout
+const _: () = assert!(
+    core::mem::size_of::<MorpheusRegSlot>() == 16,
+    "MorpheusRegSlot must be exactly 16 bytes"
+);
+
 // ============================================================================
 // Configuration constants
 // ============================================================================
@@ -459,6 +568,9 @@ pub mod config {
     /// Maximum number of workers supported
     pub const MAX_WORKERS: u32 = 1024;
 
+    /// SCB layout version (MORPHEUS_SCB_VERSION)
+    pub const SCB_VERSION: u32 = 2;
+
     /// Default time slice in nanoseconds (5ms)
     pub const DEFAULT_SLICE_NS: u64 = 5 * 1_000_000;
 
@@ -474,6 +586,8 @@ pub mod map_names {
     pub const SCB_MAP: &str = "scb_map";
     pub const HINT_RINGBUF: &str = "hint_ringbuf";
     pub const WORKER_TID_MAP: &str = "worker_tid_map";
+    pub const REG_GEN_MAP: &str = "reg_gen_map";
+    pub const REG_REGION_MAP: &str = "reg_region_map";
     pub const GLOBAL_PRESSURE_MAP: &str = "global_pressure_map";
     pub const CONFIG_MAP: &str = "config_map";
 }
@@ -489,17 +603,19 @@ mod tests {
 
     #[test]
     fn test_scb_size_and_alignment() {
-        assert_eq!(size_of::<MorpheusScb>(), 128, "SCB must be 128 bytes");
+        assert_eq!(size_of::<MorpheusScb>(), 192, "SCB must be 192 bytes");
         assert_eq!(align_of::<MorpheusScb>(), 64, "SCB must be 64-byte aligned");
     }
 
     #[test]
     fn test_scb_cache_line_offsets() {
-        // Cache Line 1: Kernel -> Runtime (bytes 0-63)
-        assert_eq!(offset_of!(MorpheusScb, preempt_seq), 0);
-        assert_eq!(offset_of!(MorpheusScb, budget_remaining_ns), 8);
+        // Cache Line 1: Kernel -> Runtime, checkpoint-critical (bytes 0-63)
+        assert_eq!(offset_of!(MorpheusScb, version), 0);
+        assert_eq!(offset_of!(MorpheusScb, worker_state), 4);
+        assert_eq!(offset_of!(MorpheusScb, preempt_seq), 8);
         assert_eq!(offset_of!(MorpheusScb, kernel_pressure_level), 16);
-        assert_eq!(offset_of!(MorpheusScb, worker_state), 20);
+        assert_eq!(offset_of!(MorpheusScb, pending_hint_reason), 20);
+        assert_eq!(offset_of!(MorpheusScb, pending_hint_deadline_ns), 24);
 
         // Cache Line 2: Runtime -> Kernel (bytes 64-127)
         assert_eq!(
@@ -512,11 +628,22 @@ mod tests {
         assert_eq!(offset_of!(MorpheusScb, runtime_priority), 80);
         assert_eq!(offset_of!(MorpheusScb, last_yield_reason), 84);
         assert_eq!(offset_of!(MorpheusScb, escalation_policy), 96);
+        assert_eq!(offset_of!(MorpheusScb, preferred_node), 100);
+
+        // Cache Line 3: Kernel-maintained stats (bytes 128-191)
+        assert_eq!(
+            offset_of!(MorpheusScb, budget_remaining_ns),
+            128,
+            "Cache line 3 must start at offset 128"
+        );
+        assert_eq!(offset_of!(MorpheusScb, last_escalation_ns), 136);
+        assert_eq!(offset_of!(MorpheusScb, hint_loss_count), 144);
+        assert_eq!(offset_of!(MorpheusScb, ringbuf_overflow_count), 148);
     }
 
     #[test]
     fn test_hint_structure() {
-        assert_eq!(size_of::<MorpheusHint>(), 24);
+        assert_eq!(size_of::<MorpheusHint>(), 32);
     }
 
     #[test]
@@ -541,6 +668,7 @@ mod tests {
         assert!(!WorkerState::Registered.can_receive_hints());
         assert!(!WorkerState::Quiescing.can_receive_hints());
         assert!(!WorkerState::Dead.can_receive_hints());
+        assert!(!WorkerState::Parked.can_receive_hints());
 
         assert!(WorkerState::Running.can_escalate());
         assert!(!WorkerState::Init.can_escalate());
@@ -96,25 +96,31 @@ class HintReason(IntEnum):
 # Shared Control Block (SCB) - ctypes structure
 # ============================================================================
 
+SCB_VERSION = 2
+
+
 class MorpheusScb(Structure):
     """
-    Shared Control Block - one per worker thread.
+    Shared Control Block v2 - one per worker thread.
     
     Must match struct morpheus_scb in morpheus_shared.h exactly.
-    Total size: 128 bytes (2 cache lines).
+    Total size: 192 bytes (3 cache lines).
     
     Layout:
-    - Cache Line 1 (bytes 0-63): Kernel -> Runtime
+    - Cache Line 1 (bytes 0-63): Kernel -> Runtime, checkpoint-critical
     - Cache Line 2 (bytes 64-127): Runtime -> Kernel
+    - Cache Line 3 (bytes 128-191): Kernel-maintained stats
     """
     _pack_ = 8
     _fields_ = [
-        # Cache Line 1: Kernel -> Runtime (bytes 0-63)
-        ("preempt_seq", c_uint64),           # 0-7
-        ("budget_remaining_ns", c_uint64),   # 8-15
+        # Cache Line 1: Kernel -> Runtime, checkpoint-critical (bytes 0-63)
+        ("version", c_uint32),               # 0-3
+        ("worker_state", c_uint32),          # 4-7
+        ("preempt_seq", c_uint64),           # 8-15
         ("kernel_pressure_level", c_uint32), # 16-19
-        ("worker_state", c_uint32),          # 20-23
-        ("_reserved0", c_uint64 * 5),        # 24-63 (5*8=40 bytes)
+        ("pending_hint_reason", c_uint32),   # 20-23
+        ("pending_hint_deadline_ns", c_uint64), # 24-31
+        ("_reserved0", c_uint32 * 8),        # 32-63
         
         # Cache Line 2: Runtime -> Kernel (bytes 64-127)
         ("is_in_critical_section", c_uint32), # 64-67
@@ -122,10 +128,17 @@ class MorpheusScb(Structure):
         ("last_ack_seq", c_uint64),           # 72-79
         ("runtime_priority", c_uint32),       # 80-83
         ("last_yield_reason", c_uint32),      # 84-87
-        ("_reserved1", c_uint64 * 1),         # 88-95 (1*8=8 bytes)
+        ("reservation_token", c_uint64),      # 88-95
         ("escalation_policy", c_uint32),      # 96-99
-        ("_pad", c_uint32),                   # 100-103
-        ("_reserved2", c_uint64 * 3),         # 104-127 (3*8=24 bytes)
+        ("preferred_node", c_uint32),         # 100-103
+        ("_reserved1", c_uint32 * 6),         # 104-127
+        
+        # Cache Line 3: Kernel-maintained stats (bytes 128-191)
+        ("budget_remaining_ns", c_uint64),    # 128-135
+        ("last_escalation_ns", c_uint64),     # 136-143
+        ("hint_loss_count", c_uint32),        # 144-147
+        ("ringbuf_overflow_count", c_uint32), # 148-151
+        ("_reserved2", c_uint32 * 10),        # 152-191
     ]
 
 
@@ -137,6 +150,7 @@ class MorpheusHint(Structure):
         ("reason", c_uint32),
         ("target_tid", c_uint32),
         ("deadline_ns", c_uint64),
+        ("emit_ns", c_uint64),
     ]
 
 
@@ -160,16 +174,24 @@ def verify_offsets():
     
     # Expected offsets from C struct (with fixed layout)
     expected = {
-        "preempt_seq": 0,
-        "budget_remaining_ns": 8,
+        "version": 0,
+        "worker_state": 4,
+        "preempt_seq": 8,
         "kernel_pressure_level": 16,
-        "worker_state": 20,
+        "pending_hint_reason": 20,
+        "pending_hint_deadline_ns": 24,
         "is_in_critical_section": 64,  # Cache line 2 start
         "escapable": 68,
         "last_ack_seq": 72,
         "runtime_priority": 80,
         "last_yield_reason": 84,
+        "reservation_token": 88,
         "escalation_policy": 96,
+        "preferred_node": 100,
+        "budget_remaining_ns": 128,  # Cache line 3 start
+        "last_escalation_ns": 136,
+        "hint_loss_count": 144,
+        "ringbuf_overflow_count": 148,
     }
     
     for field_name, expected_offset in expected.items():
@@ -181,9 +203,9 @@ def verify_offsets():
             )
     
     # Verify total size
-    if sizeof(scb) != 128:
+    if sizeof(scb) != 192:
         raise AssertionError(
-            f"SCB size mismatch: expected 128, got {sizeof(scb)}"
+            f"SCB size mismatch: expected 192, got {sizeof(scb)}"
         )
     
     return True
@@ -25,6 +25,7 @@ except ImportError:
 
 class _MorpheusStub:
     def checkpoint(self) -> bool: return False
+    def checkpoint_and_ack(self) -> bool: return False
     def yield_requested(self) -> bool: return False
     def acknowledge_yield(self) -> bool: return False
     def enter_critical_section(self) -> None: pass
@@ -37,6 +38,150 @@ if _morpheus is None:
     _morpheus = _MorpheusStub()
 
 
+def fast_checkpoint_callable():
+    """Return the cheapest available zero-arg checkpoint callable.
+
+    Prefers the native ``checkpoint_and_ack`` built-in function - a
+    METH_NOARGS PyCFunction that CPython dispatches through the
+    vectorcall protocol, measurably faster than any object's
+    ``__call__`` slot - and falls back to the plain ``checkpoint``
+    function. Cache the result in a local variable or default argument;
+    attribute lookups per call are what made the old Python-level
+    checkpoints cost 100ns+.
+    """
+    fn = getattr(_morpheus, "checkpoint_and_ack", None)
+    if fn is not None:
+        return fn
+    # Stub / degraded backends may lack everything
+    return getattr(_morpheus, "checkpoint", lambda: False)
+
+
+class CheckpointPump:
+    """Installs the C-level checkpoint in the event loop's hot path.
+
+    Once started, a cached zero-arg C callable is rescheduled via
+    ``loop.call_soon`` so exactly one checkpoint runs per callback batch:
+    no Python frame for the check itself, no per-task instrumentation,
+    and the loop stays responsive to kernel yield requests even when
+    application code never checkpoints explicitly.
+
+    Usage::
+
+        pump = CheckpointPump()
+        pump.start()          # inside a running loop
+        ...
+        pump.stop()
+    """
+
+    def __init__(self, idle_interval: float = 0.001):
+        self._check = fast_checkpoint_callable()
+        self._loop = None
+        self._running = False
+        self._idle_interval = idle_interval
+        self.yields_taken = 0
+
+    def start(self, loop=None):
+        """Begin pumping checkpoints on the given (or running) loop."""
+        if loop is None:
+            loop = asyncio.get_running_loop()
+        self._loop = loop
+        self._running = True
+        loop.call_soon(self._tick)
+
+    def stop(self):
+        """Stop pumping; the pending callback unschedules itself."""
+        self._running = False
+
+    def _tick(self):
+        if not self._running:
+            return
+        # One C call: check and, if a yield was pending, acknowledge.
+        # call_soon re-queues us behind other ready callbacks, which IS
+        # the yield from the event loop's point of view. When nothing was
+        # pending, back off to a timer instead - rescheduling with
+        # call_soon forever would keep the selector from ever blocking
+        # and spin an idle loop at 100% CPU.
+        if self._check():
+            self.yields_taken += 1
+            self._loop.call_soon(self._tick)
+        else:
+            self._loop.call_later(self._idle_interval, self._tick)
+
+
+class BatchedCheckpointer:
+    """Event-loop-iteration batched checkpointing.
+
+    Hooks the loop's ``_run_once`` boundary so a single SCB check (and a
+    single ``last_ack_seq`` store) covers every callback of an
+    iteration, instead of one check per callback: an iteration running
+    500 small callbacks performs one check, not 500 - and a yield taken
+    at the iteration boundary is free, because the loop was about to
+    return to the selector anyway.
+
+    Mid-iteration checks are only interleaved when the kernel signals
+    urgency: ``kernel_pressure_level`` above ``pressure_threshold``, or
+    a deadline-reason hint pending. In that case one extra checkpoint
+    callback is queued into the ready batch, splitting it in two.
+
+    Relies on ``BaseEventLoop._run_once`` (CPython's default loops);
+    alternative loops without it (e.g. uvloop) should use
+    :class:`CheckpointPump` instead.
+    """
+
+    def __init__(self, pressure_threshold: int = 75):
+        self._check = fast_checkpoint_callable()
+        self._pressure_threshold = pressure_threshold
+        self._loop = None
+        self._orig_run_once = None
+        self.iterations = 0
+        self.yields_taken = 0
+        self.mid_iteration_checks = 0
+
+    def install(self, loop) -> None:
+        """Hook the given loop's iteration boundary."""
+        if self._loop is not None:
+            raise RuntimeError("BatchedCheckpointer is already installed")
+        orig = getattr(loop, "_run_once", None)
+        if orig is None:
+            raise RuntimeError(
+                "event loop has no _run_once (uvloop?); use CheckpointPump"
+            )
+        self._loop = loop
+        self._orig_run_once = orig
+        loop._run_once = self._run_once
+
+    def uninstall(self) -> None:
+        """Restore the loop's original _run_once."""
+        if self._loop is not None and self._orig_run_once is not None:
+            self._loop._run_once = self._orig_run_once
+            self._loop = None
+            self._orig_run_once = None
+
+    def _urgent(self) -> bool:
+        level = _morpheus.pressure_level()
+        if level is not None and level > self._pressure_threshold:
+            return True
+        reason_fn = getattr(_morpheus, "pending_hint_reason", None)
+        if reason_fn is not None:
+            return reason_fn() == getattr(_morpheus, "HINT_DEADLINE", 4)
+        return False
+
+    def _run_once(self):
+        self.iterations += 1
+
+        # Split the upcoming callback batch only when the kernel signals
+        # urgency; otherwise the whole batch runs unchecked.
+        if self._urgent():
+            self.mid_iteration_checks += 1
+            self._loop.call_soon(self._check)
+
+        self._orig_run_once()
+
+        # One check, one ack, covering everything the iteration ran.
+        if self._check():
+            self.yields_taken += 1
+
+
 async def morpheus_checkpoint() -> bool:
     """Async checkpoint that yields the event loop if kernel requested."""
     if _morpheus.checkpoint():
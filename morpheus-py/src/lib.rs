@@ -46,6 +46,69 @@ fn checkpoint() -> bool {
     rt::checkpoint_sync()
 }
 
+/// Check for a pending yield request and acknowledge it in one C call.
+///
+/// Returns True if a yield was pending (now acknowledged); the caller
+/// should then give the event loop a chance to run other callbacks.
+/// This folds checkpoint() + acknowledge_yield() into a single
+/// C-to-Python boundary crossing, so the yes-path costs one call
+/// instead of two and the no-path is just the Rust-side TLS
+/// load-and-compare.
+#[pyfunction]
+fn checkpoint_and_ack() -> bool {
+    if rt::checkpoint_sync() {
+        morpheus_runtime::events::record_checkpoint_yield();
+        if let Some(scb) = rt::worker::try_current_scb() {
+            scb.acknowledge();
+        }
+        true
+    } else {
+        false
+    }
+}
+
+/// Cacheable zero-arg checkpoint callable for hot asyncio loops.
+///
+/// Note: plain `checkpoint_and_ack` is the faster call - as a
+/// METH_NOARGS built-in, CPython dispatches it through vectorcall,
+/// whereas instances go through the `tp_call` slot. This object exists
+/// for APIs that want a distinct callable identity per consumer (e.g.
+/// to attach state later); hot paths should cache the function.
+///
+/// ```python
+/// check = _morpheus.FastCheckpoint()
+/// for item in work:
+///     if check():
+///         await asyncio.sleep(0)
+/// ```
+#[pyclass]
+struct FastCheckpoint;
+
+#[pymethods]
+impl FastCheckpoint {
+    #[new]
+    fn new() -> Self {
+        Self
+    }
+
+    /// Check-and-acknowledge, same semantics as `checkpoint_and_ack()`
+    fn __call__(&self) -> bool {
+        checkpoint_and_ack()
+    }
+}
+
+/// Get the reason of the pending coalesced hint, if any.
+///
+/// Returns one of the HINT_* constants while a yield request is
+/// outstanding, or None. Lets adapters treat deadline hints more
+/// urgently than ordinary budget hints.
+#[pyfunction]
+fn pending_hint_reason() -> Option<u32> {
+    rt::worker::try_current_scb()
+        .and_then(|scb| scb.pending_hint())
+        .map(|(reason, _)| reason as u32)
+}
+
 /// Check if a yield is currently requested by the kernel.
 ///
 /// Unlike checkpoint(), this doesn't affect any state - it just checks.
@@ -287,6 +350,8 @@ fn init_worker(worker_id: u32, escapable: bool) -> PyResult<()> {
 fn _morpheus(m: &Bound<'_, PyModule>) -> PyResult<()> {
     m.add_function(wrap_pyfunction!(init_worker, m)?)?;
     m.add_function(wrap_pyfunction!(checkpoint, m)?)?;
+    m.add_function(wrap_pyfunction!(checkpoint_and_ack, m)?)?;
+    m.add_function(wrap_pyfunction!(pending_hint_reason, m)?)?;
     m.add_function(wrap_pyfunction!(yield_requested, m)?)?;
     m.add_function(wrap_pyfunction!(yield_now_async, m)?)?;
     m.add_function(wrap_pyfunction!(acknowledge_yield, m)?)?;
@@ -302,6 +367,7 @@ fn _morpheus(m: &Bound<'_, PyModule>) -> PyResult<()> {
     m.add_function(wrap_pyfunction!(is_defensive_mode, m)?)?;
 
     m.add_class::<CriticalSection>()?;
+    m.add_class::<FastCheckpoint>()?;
     m.add_class::<Stats>()?;
 
     // Constants
@@ -4,7 +4,8 @@
 //! BPF maps, enabling the kernel scheduler to identify Morpheus workers.
 
 use crate::error::{Error, Result};
-use std::os::fd::{AsFd, AsRawFd, BorrowedFd, FromRawFd, OwnedFd};
+use morpheus_common::{config, MorpheusRegSlot, RegSlotState};
+use std::os::fd::{AsFd, AsRawFd, BorrowedFd, FromRawFd, IntoRawFd, OwnedFd};
 
 /// Handle to BPF maps used for worker registration
 ///
@@ -15,6 +16,9 @@ pub struct BpfMaps {
     tid_map_fd: OwnedFd,
     /// scb_map: worker_id -> SCB mapping (mmappable)
     scb_map_fd: OwnedFd,
+    /// reg_gen_map: registration generation counter (optional; older
+    /// schedulers without the prefilter simply don't pin it)
+    reg_gen_fd: Option<OwnedFd>,
 }
 
 impl BpfMaps {
@@ -27,6 +31,7 @@ impl BpfMaps {
         Self {
             tid_map_fd: OwnedFd::from_raw_fd(tid_map_fd),
             scb_map_fd: OwnedFd::from_raw_fd(scb_map_fd),
+            reg_gen_fd: None,
         }
     }
 
@@ -47,13 +52,47 @@ impl BpfMaps {
             Error::BpfMap(format!("failed to open scb_map at {}: {}", scb_map_path, e))
         })?;
 
+        // The generation bump must not be opt-in: a registrant that never
+        // bumps is invisible to the BPF prefilter once any other
+        // registrant has moved the counter. The scheduler pins
+        // reg_gen_map next to the other maps, so attach it from the
+        // sibling path whenever it exists (older schedulers without the
+        // prefilter simply don't pin it, and the bump stays a no-op).
+        let reg_gen_fd = std::path::Path::new(tid_map_path)
+            .parent()
+            .map(|dir| dir.join(morpheus_common::map_names::REG_GEN_MAP))
+            .and_then(|path| Self::bpf_obj_get(&path.to_string_lossy()).ok());
+
         Ok(Self {
             tid_map_fd,
             scb_map_fd,
+            reg_gen_fd,
         })
     }
 
-    fn bpf_obj_get(pathname: &str) -> std::io::Result<OwnedFd> {
+    /// Attach the registration-generation map (pinned by the scheduler)
+    ///
+    /// When attached, `register_worker`/`unregister_worker` bump the
+    /// generation so the BPF side picks up membership changes on the next
+    /// scheduling event instead of re-probing the hash map on every one.
+    ///
+    /// Best-effort, matching the map's documented optionality: against a
+    /// scheduler that predates the prefilter and doesn't pin the
+    /// counter, the maps stay usable and bumps remain a no-op (the
+    /// kernel's gen==0 fallback keeps lazy retry working).
+    pub fn with_reg_gen_map(mut self, reg_gen_map_path: &str) -> Self {
+        match Self::bpf_obj_get(reg_gen_map_path) {
+            Ok(fd) => self.reg_gen_fd = Some(fd),
+            Err(e) => tracing::info!(
+                "reg_gen_map not available at {} ({}); generation bumps disabled",
+                reg_gen_map_path,
+                e
+            ),
+        }
+        self
+    }
+
+    pub(crate) fn bpf_obj_get(pathname: &str) -> std::io::Result<OwnedFd> {
         let c_path = std::ffi::CString::new(pathname)?;
         let attr = BpfObjGetAttr {
             pathname: c_path.as_ptr() as u64,
@@ -121,9 +160,176 @@ impl BpfMaps {
         }
 
         tracing::debug!("registered worker tid={} -> id={}", tid, worker_id);
+        self.bump_reg_generation();
         Ok(())
     }
 
+    /// Bump the registration generation so the BPF prefilter re-probes
+    ///
+    /// Lossy read-increment-write: concurrent registrations may collapse
+    /// bumps, but the counter still changes, which is all the BPF side
+    /// needs to re-run its hash probe. No-op when the map isn't attached.
+    fn bump_reg_generation(&self) {
+        let fd = match self.reg_gen_fd {
+            Some(ref fd) => fd,
+            None => return,
+        };
+
+        let key = 0u32.to_ne_bytes();
+        let mut current = [0u8; 8];
+
+        // BPF_MAP_LOOKUP_ELEM shares the update attr layout (value is the
+        // output buffer). A failed lookup leaves current at zero.
+        let _ = unsafe {
+            libc::syscall(
+                libc::SYS_bpf,
+                1, // BPF_MAP_LOOKUP_ELEM
+                &BpfMapUpdateAttr {
+                    map_fd: fd.as_raw_fd() as u32,
+                    _pad0: 0,
+                    key: key.as_ptr() as u64,
+                    value: current.as_mut_ptr() as u64,
+                    flags: 0,
+                } as *const _ as *const libc::c_void,
+                std::mem::size_of::<BpfMapUpdateAttr>(),
+            )
+        };
+
+        let next = u64::from_ne_bytes(current).wrapping_add(1).to_ne_bytes();
+        let ret = unsafe {
+            libc::syscall(
+                libc::SYS_bpf,
+                2, // BPF_MAP_UPDATE_ELEM
+                &BpfMapUpdateAttr {
+                    map_fd: fd.as_raw_fd() as u32,
+                    _pad0: 0,
+                    key: key.as_ptr() as u64,
+                    value: next.as_ptr() as u64,
+                    flags: 0, // BPF_ANY
+                } as *const _ as *const libc::c_void,
+                std::mem::size_of::<BpfMapUpdateAttr>(),
+            )
+        };
+
+        if ret < 0 {
+            tracing::warn!(
+                "failed to bump registration generation: {}",
+                std::io::Error::last_os_error()
+            );
+        }
+    }
+
+    /// Register an entire worker set in one syscall
+    ///
+    /// Uses BPF_MAP_UPDATE_BATCH so bringing up a large pool costs one
+    /// kernel transition instead of one per thread, then bumps the
+    /// registration generation once so the BPF side picks the whole set
+    /// up on the next scheduling event. `workers` is `(tid, worker_id)`
+    /// pairs. Returns the number of entries the kernel processed.
+    pub fn register_workers(&self, workers: &[(u32, u32)]) -> Result<u32> {
+        if workers.is_empty() {
+            return Ok(0);
+        }
+
+        let keys: Vec<u32> = workers.iter().map(|(tid, _)| *tid).collect();
+        let values: Vec<u32> = workers.iter().map(|(_, id)| *id).collect();
+
+        let mut attr = BpfMapBatchAttr {
+            in_batch: 0,
+            out_batch: 0,
+            keys: keys.as_ptr() as u64,
+            values: values.as_ptr() as u64,
+            count: workers.len() as u32,
+            map_fd: self.tid_map_fd.as_raw_fd() as u32,
+            elem_flags: 0, // BPF_ANY
+            flags: 0,
+        };
+
+        let ret = unsafe {
+            libc::syscall(
+                libc::SYS_bpf,
+                26, // BPF_MAP_UPDATE_BATCH
+                &mut attr as *mut _ as *mut libc::c_void,
+                std::mem::size_of::<BpfMapBatchAttr>(),
+            )
+        };
+
+        // The kernel writes back how many entries it processed
+        let processed = attr.count;
+        if ret < 0 {
+            let err = std::io::Error::last_os_error();
+            if processed == 0 {
+                return Err(Error::Registration(format!(
+                    "bulk register of {} workers failed: {}",
+                    workers.len(),
+                    err
+                )));
+            }
+            tracing::warn!(
+                "bulk register partially failed after {}/{} entries: {}",
+                processed,
+                workers.len(),
+                err
+            );
+        }
+
+        tracing::debug!(
+            "bulk registered {}/{} workers",
+            processed,
+            workers.len()
+        );
+        self.bump_reg_generation();
+        Ok(processed)
+    }
+
+    /// Deregister an entire worker set in one syscall
+    ///
+    /// Uses BPF_MAP_DELETE_BATCH; missing TIDs are tolerated the same
+    /// way `unregister_worker` tolerates ENOENT. Returns the number of
+    /// entries the kernel processed.
+    pub fn unregister_workers(&self, tids: &[u32]) -> Result<u32> {
+        if tids.is_empty() {
+            return Ok(0);
+        }
+
+        let mut attr = BpfMapBatchAttr {
+            in_batch: 0,
+            out_batch: 0,
+            keys: tids.as_ptr() as u64,
+            values: 0,
+            count: tids.len() as u32,
+            map_fd: self.tid_map_fd.as_raw_fd() as u32,
+            elem_flags: 0,
+            flags: 0,
+        };
+
+        let ret = unsafe {
+            libc::syscall(
+                libc::SYS_bpf,
+                27, // BPF_MAP_DELETE_BATCH
+                &mut attr as *mut _ as *mut libc::c_void,
+                std::mem::size_of::<BpfMapBatchAttr>(),
+            )
+        };
+
+        let processed = attr.count;
+        if ret < 0 && processed == 0 {
+            let err = std::io::Error::last_os_error();
+            // ENOENT means some TID was already gone - not a failure
+            if err.raw_os_error() != Some(libc::ENOENT) {
+                return Err(Error::Registration(format!(
+                    "bulk unregister of {} workers failed: {}",
+                    tids.len(),
+                    err
+                )));
+            }
+        }
+
+        tracing::debug!("bulk unregistered {}/{} workers", processed, tids.len());
+        self.bump_reg_generation();
+        Ok(processed)
+    }
+
     /// Unregister a worker thread from the kernel
     ///
     /// This removes the TID from the BPF hash map.
@@ -156,8 +362,110 @@ impl BpfMaps {
         }
 
         tracing::debug!("unregistered worker tid={}", tid);
+        self.bump_reg_generation();
+        Ok(())
+    }
+}
+
+/// Memory-mapped view of the syscall-free registration region
+///
+/// One `MorpheusRegSlot` per worker_id, shared with the BPF scheduler
+/// via a `BPF_F_MMAPABLE` array. Registering and deregistering are plain
+/// atomic stores into a slot; the scheduler's timer sweeps the region,
+/// mirrors membership into its hash map, and bumps the registration
+/// generation itself. Use this instead of
+/// [`BpfMaps::register_worker`]/[`BpfMaps::unregister_worker`] when
+/// worker pool churn is on the request path - spawn and teardown cost
+/// zero syscalls.
+pub struct RegRegion {
+    ptr: std::ptr::NonNull<MorpheusRegSlot>,
+    // Keep the mapping alive
+    _mmap: memmap2::MmapMut,
+}
+
+// Slot access is thread-safe through atomics
+unsafe impl Send for RegRegion {}
+unsafe impl Sync for RegRegion {}
+
+impl RegRegion {
+    /// Map the registration region pinned by the scheduler
+    pub fn from_pinned_path(reg_region_path: &str) -> Result<Self> {
+        let fd = BpfMaps::bpf_obj_get(reg_region_path).map_err(|e| {
+            Error::BpfMap(format!(
+                "failed to open reg_region_map at {}: {}",
+                reg_region_path, e
+            ))
+        })?;
+
+        let len = config::MAX_WORKERS as usize * std::mem::size_of::<MorpheusRegSlot>();
+        let file = unsafe { std::fs::File::from_raw_fd(fd.into_raw_fd()) };
+        let mmap = unsafe { memmap2::MmapOptions::new().len(len).map_mut(&file) }
+            .map_err(Error::Mmap)?;
+
+        let ptr = std::ptr::NonNull::new(mmap.as_ptr() as *mut MorpheusRegSlot)
+            .ok_or_else(|| Error::Mmap(std::io::Error::other("mmap returned null")))?;
+
+        Ok(Self { ptr, _mmap: mmap })
+    }
+
+    fn slot(&self, worker_id: u32) -> Result<&MorpheusRegSlot> {
+        if worker_id >= config::MAX_WORKERS {
+            return Err(Error::InvalidWorker(worker_id));
+        }
+        // SAFETY: worker_id is bounds-checked against the mapped length
+        Ok(unsafe { &*self.ptr.as_ptr().add(worker_id as usize) })
+    }
+
+    /// Register a worker without a syscall
+    ///
+    /// The kernel picks the slot up on its next region sweep (one timer
+    /// interval at most). Fails if the slot is still in use.
+    pub fn register_worker(&self, tid: u32, worker_id: u32) -> Result<()> {
+        use std::sync::atomic::Ordering;
+
+        let slot = self.slot(worker_id)?;
+        if slot.state.load(Ordering::Acquire) != RegSlotState::Free as u32 {
+            return Err(Error::Registration(format!(
+                "registration slot {} still in use",
+                worker_id
+            )));
+        }
+
+        slot.tid.store(tid, Ordering::Relaxed);
+        slot.worker_id.store(worker_id, Ordering::Relaxed);
+        // State store is the publish: kernel reads fields only after it
+        // observes CLAIMED.
+        slot.state
+            .store(RegSlotState::Claimed as u32, Ordering::Release);
+
+        tracing::debug!("claimed registration slot {} for tid={}", worker_id, tid);
+        Ok(())
+    }
+
+    /// Deregister a worker without a syscall
+    pub fn unregister_worker(&self, worker_id: u32) -> Result<()> {
+        use std::sync::atomic::Ordering;
+
+        let slot = self.slot(worker_id)?;
+        if slot.state.load(Ordering::Acquire) == RegSlotState::Free as u32 {
+            return Ok(()); // Already released
+        }
+
+        slot.state
+            .store(RegSlotState::Releasing as u32, Ordering::Release);
+
+        tracing::debug!("released registration slot {}", worker_id);
         Ok(())
     }
+
+    /// Read the current state of a registration slot
+    pub fn slot_state(&self, worker_id: u32) -> Result<RegSlotState> {
+        use std::sync::atomic::Ordering;
+
+        let slot = self.slot(worker_id)?;
+        RegSlotState::try_from(slot.state.load(Ordering::Acquire))
+            .map_err(|_| Error::BpfMap("invalid registration slot state".to_string()))
+    }
 }
 
 /// BPF_MAP_UPDATE_ELEM attribute structure
@@ -171,13 +479,26 @@ struct BpfMapUpdateAttr {
     flags: u64,
 }
 
-#[allow(dead_code)]
+#[repr(C)]
 struct BpfMapDeleteAttr {
     map_fd: u32,
     _pad0: u32, // Padding for 8-byte alignment
     key: u64,
 }
 
+/// BPF_MAP_*_BATCH attribute structure
+#[repr(C)]
+struct BpfMapBatchAttr {
+    in_batch: u64,
+    out_batch: u64,
+    keys: u64,
+    values: u64,
+    count: u32,
+    map_fd: u32,
+    elem_flags: u64,
+    flags: u64,
+}
+
 #[repr(C)]
 struct BpfObjGetAttr {
     pathname: u64,
@@ -194,5 +515,6 @@ mod tests {
         // Ensure our attr structs match expected sizes with proper padding
         assert_eq!(std::mem::size_of::<BpfMapUpdateAttr>(), 32);
         assert_eq!(std::mem::size_of::<BpfMapDeleteAttr>(), 16);
+        assert_eq!(std::mem::size_of::<BpfMapBatchAttr>(), 56);
     }
 }
@@ -13,6 +13,7 @@
 use crate::worker;
 use std::cell::Cell;
 use std::marker::PhantomData;
+use std::sync::atomic::{AtomicBool, Ordering};
 
 /// RAII guard for critical sections
 ///
@@ -49,6 +50,49 @@ pub struct CriticalGuard {
 thread_local! {
     /// Track critical section nesting depth
     static CRITICAL_DEPTH: Cell<u32> = const { Cell::new(0) };
+
+    /// Whether the SCB flag was published for the current outer section
+    static FLAG_PUBLISHED: Cell<bool> = const { Cell::new(false) };
+}
+
+/// Lazy-publication mode (process-wide)
+///
+/// In eager mode (the default) every outer enter/exit stores to the
+/// SCB's `is_in_critical_section` - a cross-core-visible write pair that
+/// makes the shared cache line ping-pong when critical sections are
+/// taken millions of times per second. In lazy mode, enter/exit touch
+/// only the thread-local depth; the SCB flag is published only when a
+/// yield request is actually pending (one acquire load of `preempt_seq`,
+/// a line checkpoints read anyway).
+///
+/// The kernel tolerates the publication delay with a one-tick
+/// confirmation window before escalating, so a pending hint observed at
+/// the next guard entry still protects the section. The tradeoff: a
+/// single very long FFI call entered before the hint arrived is not
+/// protected until the next guard or checkpoint - workers doing
+/// multi-second opaque calls should stay on eager mode.
+static LAZY_PUBLICATION: AtomicBool = AtomicBool::new(false);
+
+/// Enable or disable lazy critical-section flag publication
+pub fn set_lazy_publication(enabled: bool) {
+    LAZY_PUBLICATION.store(enabled, Ordering::Release);
+}
+
+/// Check whether lazy publication is enabled
+pub fn lazy_publication() -> bool {
+    LAZY_PUBLICATION.load(Ordering::Acquire)
+}
+
+/// Publish the SCB flag if a yield request is pending (lazy mode)
+#[inline]
+fn publish_if_pending() -> bool {
+    if let Some(scb) = worker::try_current_scb() {
+        if scb.yield_requested() {
+            scb.enter_critical();
+            return true;
+        }
+    }
+    false
 }
 
 /// Enter a critical section
@@ -83,11 +127,26 @@ pub fn critical_section() -> CriticalGuard {
         let current = depth.get();
         depth.set(current + 1);
 
-        // Only set the SCB flag on first entry
         if current == 0 {
-            if let Some(scb) = worker::try_current_scb() {
+            // Outer entry: eager mode always publishes; lazy mode only
+            // when a yield request is already pending.
+            let published = if lazy_publication() {
+                publish_if_pending()
+            } else if let Some(scb) = worker::try_current_scb() {
                 scb.enter_critical();
-            }
+                true
+            } else {
+                false
+            };
+            FLAG_PUBLISHED.with(|flag| flag.set(published));
+        } else if lazy_publication() {
+            // Nested entry: upgrade promptly if a hint arrived since the
+            // outer guard was taken.
+            FLAG_PUBLISHED.with(|flag| {
+                if !flag.get() && publish_if_pending() {
+                    flag.set(true);
+                }
+            });
         }
 
         CriticalGuard {
@@ -104,8 +163,9 @@ impl Drop for CriticalGuard {
             debug_assert!(current > 0, "CriticalGuard dropped without matching enter");
             depth.set(current - 1);
 
-            // Only clear the SCB flag on last exit
-            if current == 1 {
+            // Only clear the SCB flag on last exit, and only if it was
+            // actually published for this section.
+            if current == 1 && FLAG_PUBLISHED.with(|flag| flag.replace(false)) {
                 if let Some(scb) = worker::try_current_scb() {
                     scb.exit_critical();
                 }
@@ -35,4 +35,8 @@ pub enum Error {
     /// Operation not supported
     #[error("operation not supported: {0}")]
     NotSupported(String),
+
+    /// Deadline reservation rejected by admission control
+    #[error("reservation rejected: {0}")]
+    ReservationRejected(String),
 }
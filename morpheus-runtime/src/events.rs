@@ -0,0 +1,283 @@
+//! Per-worker yield-cause event rings
+//!
+//! The SCB's `last_yield_reason` is a single word - by the time anyone
+//! looks, it's been overwritten. Each worker instead records every yield
+//! it takes into a fixed-size lock-free SPSC ring (worker writes,
+//! collector reads): `{timestamp_ns, reason, pending_seq_delta,
+//! queue_depth}`. A collector drains rings periodically and feeds
+//! latency-between-yields histograms per [`YieldReason`] into
+//! [`MorpheusMetrics`], turning "why did p99 regress" into a dashboard
+//! query instead of a debug_mode restart.
+//!
+//! Bounded memory (the ring drops and counts on overflow), no locks, a
+//! few nanoseconds per record.
+
+use crate::metrics::MorpheusMetrics;
+use crate::worker;
+use morpheus_common::YieldReason;
+use std::cell::{RefCell, UnsafeCell};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Arc, Weak};
+use std::time::Instant;
+
+/// Default ring capacity per worker (events)
+pub const DEFAULT_RING_CAPACITY: usize = 1024;
+
+/// One recorded yield
+#[derive(Debug, Clone, Copy, Default)]
+pub struct YieldEvent {
+    /// Monotonic timestamp of the yield
+    pub timestamp_ns: u64,
+    /// Why the yield was taken (YieldReason discriminant)
+    pub reason: u32,
+    /// preempt_seq - last_ack_seq at the time of the yield
+    pub pending_seq_delta: u64,
+    /// Local run queue depth at the time of the yield
+    pub queue_depth: u32,
+}
+
+/// Fixed-size lock-free SPSC event ring
+///
+/// The owning worker is the only producer; one collector thread is the
+/// only consumer. Overflow drops the newest event and counts it -
+/// recording must never block or allocate.
+pub struct YieldEventRing {
+    slots: Box<[UnsafeCell<YieldEvent>]>,
+    mask: u64,
+    /// Next write position (producer-owned, consumer reads)
+    head: AtomicU64,
+    /// Next read position (consumer-owned, producer reads)
+    tail: AtomicU64,
+    /// Events dropped because the ring was full
+    dropped: AtomicU64,
+    /// Timestamp of the previous drained event (consumer-owned)
+    last_drained_ns: AtomicU64,
+    /// Epoch for relative timestamps
+    epoch: Instant,
+}
+
+// SPSC discipline: slots are only written by the producer at positions
+// the consumer has not yet claimed, and vice versa.
+unsafe impl Send for YieldEventRing {}
+unsafe impl Sync for YieldEventRing {}
+
+impl YieldEventRing {
+    /// Create a ring with the given capacity (rounded up to a power of two)
+    pub fn new(capacity: usize) -> Arc<Self> {
+        let capacity = capacity.next_power_of_two().max(2);
+        Arc::new(Self {
+            slots: (0..capacity)
+                .map(|_| UnsafeCell::new(YieldEvent::default()))
+                .collect(),
+            mask: capacity as u64 - 1,
+            head: AtomicU64::new(0),
+            tail: AtomicU64::new(0),
+            dropped: AtomicU64::new(0),
+            last_drained_ns: AtomicU64::new(0),
+            epoch: Instant::now(),
+        })
+    }
+
+    /// Record a yield (producer side - the worker itself)
+    #[inline]
+    pub fn record(&self, reason: YieldReason, pending_seq_delta: u64, queue_depth: u32) {
+        let head = self.head.load(Ordering::Relaxed);
+        let tail = self.tail.load(Ordering::Acquire);
+
+        if head.wrapping_sub(tail) > self.mask {
+            self.dropped.fetch_add(1, Ordering::Relaxed);
+            return;
+        }
+
+        let event = YieldEvent {
+            timestamp_ns: self.epoch.elapsed().as_nanos() as u64,
+            reason: reason as u32,
+            pending_seq_delta,
+            queue_depth,
+        };
+
+        // SAFETY: single producer; the slot at head is not visible to
+        // the consumer until the head store below.
+        unsafe {
+            *self.slots[(head & self.mask) as usize].get() = event;
+        }
+        self.head.store(head.wrapping_add(1), Ordering::Release);
+    }
+
+    /// Drain all available events (consumer side)
+    pub fn drain(&self, mut f: impl FnMut(&YieldEvent)) -> usize {
+        let head = self.head.load(Ordering::Acquire);
+        let mut tail = self.tail.load(Ordering::Relaxed);
+        let mut drained = 0;
+
+        while tail != head {
+            // SAFETY: single consumer; the producer will not overwrite
+            // this slot until tail advances past it.
+            let event = unsafe { *self.slots[(tail & self.mask) as usize].get() };
+            f(&event);
+            tail = tail.wrapping_add(1);
+            drained += 1;
+        }
+
+        self.tail.store(tail, Ordering::Release);
+        drained
+    }
+
+    /// Events dropped due to a full ring
+    pub fn dropped(&self) -> u64 {
+        self.dropped.load(Ordering::Relaxed)
+    }
+
+    /// Drain into the metrics registry as inter-yield latency per reason
+    ///
+    /// The gap between consecutive yields (regardless of reason) is
+    /// attributed to the reason of the later yield: "time we ran before
+    /// yielding because of X".
+    pub fn drain_into_metrics(&self, metrics: &MorpheusMetrics) -> usize {
+        let mut last_ns = self.last_drained_ns.load(Ordering::Relaxed);
+
+        let drained = self.drain(|event| {
+            if last_ns > 0 && event.timestamp_ns > last_ns {
+                if let Ok(reason) = YieldReason::try_from(event.reason) {
+                    metrics.record_yield_interval(reason, event.timestamp_ns - last_ns);
+                }
+            }
+            last_ns = event.timestamp_ns;
+        });
+
+        self.last_drained_ns.store(last_ns, Ordering::Relaxed);
+        drained
+    }
+}
+
+/// Process-global registry of rings to drain at scrape time
+///
+/// Executors register their ring on construction; dead entries are
+/// pruned as they are encountered. The mutex both protects the Vec and
+/// serializes draining, preserving each ring's single-consumer
+/// discipline when several scrapers race.
+static COLLECTED_RINGS: parking_lot::Mutex<Vec<Weak<YieldEventRing>>> =
+    parking_lot::Mutex::new(Vec::new());
+
+/// Register a ring for scrape-time collection
+pub(crate) fn register_ring_for_collection(ring: &Arc<YieldEventRing>) {
+    COLLECTED_RINGS.lock().push(Arc::downgrade(ring));
+}
+
+/// Drain every registered ring into the given metrics registry
+///
+/// Called from the metrics scrape path, so the promised
+/// `morpheus_yield_interval_seconds` series populate without each
+/// deployment writing its own collector thread. Returns the number of
+/// events drained.
+pub fn drain_registered_rings(metrics: &MorpheusMetrics) -> usize {
+    let mut rings = COLLECTED_RINGS.lock();
+    rings.retain(|ring| ring.strong_count() > 0);
+    rings
+        .iter()
+        .filter_map(Weak::upgrade)
+        .map(|ring| ring.drain_into_metrics(metrics))
+        .sum()
+}
+
+thread_local! {
+    /// The yield event ring of the current worker thread, if any
+    static EVENT_RING: RefCell<Option<Arc<YieldEventRing>>> = const { RefCell::new(None) };
+}
+
+/// Install the event ring for the current worker thread
+pub fn install_ring(ring: Arc<YieldEventRing>) {
+    EVENT_RING.with(|r| *r.borrow_mut() = Some(ring));
+}
+
+/// Remove the event ring from the current thread
+pub fn clear_ring() {
+    EVENT_RING.with(|r| *r.borrow_mut() = None);
+}
+
+/// Record a yield on the current thread's ring, if one is installed
+#[inline]
+pub fn record_yield(reason: YieldReason, pending_seq_delta: u64, queue_depth: u32) {
+    EVENT_RING.with(|r| {
+        if let Some(ring) = r.borrow().as_ref() {
+            ring.record(reason, pending_seq_delta, queue_depth);
+        }
+    });
+}
+
+/// Record a checkpoint-driven yield (used by the `checkpoint!` macros)
+///
+/// Reads the pending sequence delta from the current SCB when one is
+/// installed. Only called on the yield path, so the Arc clone is off the
+/// hot no-yield case.
+pub fn record_checkpoint_yield() {
+    let delta = worker::try_current_scb()
+        .map(|scb| {
+            let scb = scb.scb();
+            scb.preempt_seq
+                .load(Ordering::Relaxed)
+                .saturating_sub(scb.last_ack_seq.load(Ordering::Relaxed))
+        })
+        .unwrap_or(0);
+
+    record_yield(YieldReason::Checkpoint, delta, 0);
+    crate::ringbuf::note_hint_ack();
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_ring_records_and_drains_in_order() {
+        let ring = YieldEventRing::new(8);
+        ring.record(YieldReason::Hint, 1, 3);
+        ring.record(YieldReason::Budget, 2, 4);
+
+        let mut seen = Vec::new();
+        ring.drain(|e| seen.push((e.reason, e.pending_seq_delta, e.queue_depth)));
+        assert_eq!(
+            seen,
+            vec![
+                (YieldReason::Hint as u32, 1, 3),
+                (YieldReason::Budget as u32, 2, 4)
+            ]
+        );
+        assert_eq!(ring.drain(|_| {}), 0);
+    }
+
+    #[test]
+    fn test_ring_overflow_drops_and_counts() {
+        let ring = YieldEventRing::new(4);
+        for _ in 0..10 {
+            ring.record(YieldReason::Defensive, 0, 0);
+        }
+        assert_eq!(ring.dropped(), 6);
+        assert_eq!(ring.drain(|_| {}), 4);
+
+        // Space reclaimed after drain
+        ring.record(YieldReason::Hint, 0, 0);
+        assert_eq!(ring.drain(|_| {}), 1);
+    }
+
+    #[test]
+    fn test_drain_into_metrics_feeds_intervals() {
+        let ring = YieldEventRing::new(8);
+        let metrics = MorpheusMetrics::with_capacity(4);
+
+        ring.record(YieldReason::Checkpoint, 0, 0);
+        std::thread::sleep(std::time::Duration::from_millis(2));
+        ring.record(YieldReason::Budget, 1, 0);
+
+        assert_eq!(ring.drain_into_metrics(&metrics), 2);
+        let output = metrics.render();
+        assert!(output.contains("morpheus_yield_interval_seconds"));
+        assert!(output.contains("reason=\"budget\""));
+    }
+
+    #[test]
+    fn test_tls_record_without_ring_is_noop() {
+        clear_ring();
+        record_yield(YieldReason::Hint, 0, 0); // Must not panic
+    }
+}
@@ -2,17 +2,47 @@
 //!
 //! Each worker runs a local async executor. The executor checks for
 //! kernel yield requests at poll boundaries.
+//!
+//! # Scheduling model
+//!
+//! - **LIFO slot**: a wake that happens on the worker itself lands in a
+//!   single-task LIFO slot and runs next, keeping message-passing task
+//!   chains on a hot cache. The displaced task falls back to the FIFO
+//!   queue so the slot cannot starve it.
+//! - **Local FIFO queue**: spawned and displaced tasks, drained in order.
+//! - **Global injector**: wakes from non-worker threads (or from workers
+//!   of a different runtime) are pushed here and unpark a sleeping worker.
+//! - **Stealing**: an idle worker steals a batch (half the victim's
+//!   queue) from the injector or a sibling before giving up.
+//! - **Parking**: a worker with no work parks its thread instead of
+//!   spinning; producers unpark one sleeper per off-worker wake.
 
 use crate::critical::in_critical_section;
+use crate::events::{self, YieldEventRing};
 use crate::ringbuf::DefensiveMode;
 use crate::worker;
 use async_task::{Runnable, Task};
-use crossbeam::deque::{Injector, Stealer, Worker as WorkQueue};
-use std::cell::RefCell;
+use crossbeam::deque::{Injector, Steal, Stealer, Worker as WorkQueue};
+use morpheus_common::{HintReason, WorkerState, YieldReason};
+use parking_lot::Mutex;
+use std::cell::{Cell, RefCell};
 use std::future::Future;
+use std::rc::Rc;
 use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::Arc;
 use std::task::{Context, Poll};
+use std::thread::Thread;
+
+/// Empty ticks before an idle worker parks (scale-down hysteresis)
+const IDLE_TICKS_BEFORE_PARK: u32 = 64;
+/// Consecutive LIFO-slot polls before the slot is forced behind the
+/// FIFO queue, so a wake-each-other task pair cannot starve it
+const MAX_LIFO_POLLS: u32 = 16;
+/// Every Nth tick the injector is polled ahead of the local queues, so
+/// cross-thread work cannot be starved by a busy local slot/FIFO cycle
+const GLOBAL_QUEUE_INTERVAL: u32 = 61;
+/// kernel_pressure_level above which an idle worker parks immediately
+const PRESSURE_PARK_THRESHOLD: u32 = 75;
 
 /// Executor statistics
 #[derive(Debug, Default)]
@@ -27,102 +57,382 @@ pub struct ExecutorStats {
     pub defensive_yields: AtomicU64,
     /// Total polls
     pub polls: AtomicU64,
+    /// Tasks taken from the injector or stolen from siblings
+    pub tasks_stolen: AtomicU64,
+    /// Times this worker parked with no work
+    pub parks: AtomicU64,
+}
+
+/// State shared by every executor of one runtime
+///
+/// Owns the global injector and the parking registry. Wakes that happen
+/// off-worker go through here: push to the injector, unpark one sleeper.
+pub struct ExecutorShared {
+    /// Global queue for cross-thread spawns and off-worker wakes
+    injector: Injector<Runnable>,
+    /// Threads currently parked waiting for work
+    parked: Mutex<Vec<Thread>>,
+    /// Shutdown flag checked by worker run loops
+    shutdown: AtomicBool,
+}
+
+impl ExecutorShared {
+    /// Create the shared executor state
+    pub fn new() -> Arc<Self> {
+        Arc::new(Self {
+            injector: Injector::new(),
+            parked: Mutex::new(Vec::new()),
+            shutdown: AtomicBool::new(false),
+        })
+    }
+
+    /// Spawn a task from any thread
+    ///
+    /// On a worker of this runtime the task lands in that worker's LIFO
+    /// slot; elsewhere it goes through the injector and unparks a sleeper.
+    pub fn spawn<F>(self: &Arc<Self>, future: F) -> Task<F::Output>
+    where
+        F: Future + Send + 'static,
+        F::Output: Send + 'static,
+    {
+        let (runnable, task) = async_task::spawn(future, schedule_fn(self.clone()));
+        runnable.schedule();
+        task
+    }
+
+    /// Request shutdown and wake every parked worker
+    pub fn shutdown(&self) {
+        self.shutdown.store(true, Ordering::Release);
+        for thread in self.parked.lock().drain(..) {
+            thread.unpark();
+        }
+    }
+
+    /// Check if shutdown was requested
+    pub fn is_shutdown(&self) -> bool {
+        self.shutdown.load(Ordering::Acquire)
+    }
+
+    /// Unpark one sleeping worker, if any
+    fn unpark_one(&self) {
+        if let Some(thread) = self.parked.lock().pop() {
+            thread.unpark();
+        }
+    }
+}
+
+/// Per-thread scheduling context installed by [`LocalExecutor::run`]
+///
+/// The schedule closure consults this to route same-thread wakes to the
+/// worker's own queues without touching the injector.
+struct WorkerContext {
+    /// Shared state of the runtime this worker belongs to
+    shared: Arc<ExecutorShared>,
+    /// Local FIFO queue
+    local: WorkQueue<Runnable>,
+    /// LIFO slot for the freshest same-thread wake
+    lifo: Cell<Option<Runnable>>,
+}
+
+thread_local! {
+    /// The scheduling context of the current worker thread, if any
+    static CONTEXT: RefCell<Option<Rc<WorkerContext>>> = const { RefCell::new(None) };
+}
+
+/// Build the schedule closure for tasks of the given runtime
+///
+/// Fast path: a wake on a worker of the same runtime lands in its LIFO
+/// slot (displacing the previous occupant to the FIFO queue). Anything
+/// else goes to the injector and unparks a sleeper.
+fn schedule_fn(shared: Arc<ExecutorShared>) -> impl Fn(Runnable) + Send + Sync + 'static {
+    move |runnable| {
+        let mut runnable = Some(runnable);
+
+        let handled = CONTEXT.with(|ctx| {
+            if let Some(ctx) = ctx.borrow().as_ref() {
+                if Arc::ptr_eq(&ctx.shared, &shared) {
+                    let fresh = runnable.take().expect("runnable consumed twice");
+                    if let Some(displaced) = ctx.lifo.replace(Some(fresh)) {
+                        ctx.local.push(displaced);
+                    }
+                    return true;
+                }
+            }
+            false
+        });
+
+        if !handled {
+            shared
+                .injector
+                .push(runnable.take().expect("runnable consumed twice"));
+            shared.unpark_one();
+        }
+    }
 }
 
 /// Local executor for a single worker thread
+///
+/// Not `Send`: it owns the thread's scheduling context. Construct it on
+/// the worker thread itself.
 pub struct LocalExecutor {
-    /// Local task queue
-    queue: WorkQueue<Runnable>,
-    /// Global injector for cross-thread spawns
-    injector: Arc<Injector<Runnable>>,
-    /// Stealers from other workers (for work stealing)
+    /// This worker's scheduling context (queues + runtime identity)
+    ctx: Rc<WorkerContext>,
+    /// Stealers for the sibling workers' local queues
     stealers: Vec<Stealer<Runnable>>,
     /// Defensive mode controller
     defensive: Arc<DefensiveMode>,
     /// Statistics
     stats: Arc<ExecutorStats>,
-    /// Shutdown flag
-    shutdown: Arc<AtomicBool>,
+    /// Yield-cause event ring (worker writes, collector drains)
+    events: Arc<YieldEventRing>,
+    /// Consecutive ticks served from the LIFO slot (anti-starvation)
+    lifo_streak: Cell<u32>,
+    /// Tick counter driving the periodic injector poll
+    tick_count: Cell<u32>,
 }
 
 impl LocalExecutor {
-    /// Create a new local executor
+    /// Create a new local executor bound to the shared runtime state
     pub fn new(
-        injector: Arc<Injector<Runnable>>,
+        shared: Arc<ExecutorShared>,
         stealers: Vec<Stealer<Runnable>>,
         defensive: Arc<DefensiveMode>,
     ) -> Self {
         Self {
-            queue: WorkQueue::new_fifo(),
-            injector,
+            ctx: Rc::new(WorkerContext {
+                shared,
+                local: WorkQueue::new_fifo(),
+                lifo: Cell::new(None),
+            }),
             stealers,
             defensive,
             stats: Arc::new(ExecutorStats::default()),
-            shutdown: Arc::new(AtomicBool::new(false)),
+            events: {
+                // Registered so the metrics scrape path drains it; the
+                // promised per-reason interval series need no bespoke
+                // collector thread.
+                let ring = YieldEventRing::new(events::DEFAULT_RING_CAPACITY);
+                events::register_ring_for_collection(&ring);
+                ring
+            },
+            lifo_streak: Cell::new(0),
+            tick_count: Cell::new(0),
         }
     }
 
+    /// Get this worker's yield event ring (for a collector to drain)
+    pub fn event_ring(&self) -> Arc<YieldEventRing> {
+        self.events.clone()
+    }
+
+    /// Get a stealer for this worker's local queue
+    ///
+    /// Hand these to sibling executors so they can steal batches when
+    /// their own queues run dry.
+    pub fn stealer(&self) -> Stealer<Runnable> {
+        self.ctx.local.stealer()
+    }
+
+    /// Wire in a sibling worker's stealer
+    ///
+    /// Executors are `!Send` and built on their own threads, so sibling
+    /// stealers usually don't exist yet at construction time: create the
+    /// executors, exchange `stealer()` handles, then add them here
+    /// before calling [`run`](Self::run).
+    pub fn add_stealer(&mut self, stealer: Stealer<Runnable>) {
+        self.stealers.push(stealer);
+    }
+
     /// Spawn a task on this executor
     pub fn spawn<F>(&self, future: F) -> Task<F::Output>
     where
         F: Future + Send + 'static,
         F::Output: Send + 'static,
     {
-        let _stats = self.stats.clone();
-        let schedule = move |runnable: Runnable| {
-            // Schedule to thread-local queue if on worker, else to injector
-            // For simplicity, always push to the local queue
-            // In a real implementation, this would check the current thread
-            runnable.run();
-        };
-
-        let (runnable, task) = async_task::spawn(future, schedule);
-        self.queue.push(runnable);
+        let (runnable, task) = async_task::spawn(future, schedule_fn(self.ctx.shared.clone()));
+        self.ctx.local.push(runnable);
         self.stats.tasks_spawned.fetch_add(1, Ordering::Relaxed);
         task
     }
 
-    /// Run the executor until shutdown
+    /// Run the executor until shutdown, parking when idle
+    ///
+    /// Scale-down hysteresis: a worker spins through a bounded number of
+    /// empty ticks before parking, so brief gaps in the workload don't
+    /// thrash the park/unpark path. Under high kernel pressure the
+    /// hysteresis is skipped - an idle worker on a pressured machine
+    /// should give its CPU back immediately.
     pub fn run(&self) {
-        while !self.shutdown.load(Ordering::Relaxed) {
-            self.tick();
+        self.enter();
+        let mut idle_ticks = 0u32;
+
+        while !self.ctx.shared.is_shutdown() {
+            if self.tick() {
+                idle_ticks = 0;
+                continue;
+            }
+
+            idle_ticks += 1;
+            let pressured = worker::try_current_scb()
+                .map(|scb| scb.pressure_level() > PRESSURE_PARK_THRESHOLD)
+                .unwrap_or(false);
+
+            if pressured || idle_ticks >= IDLE_TICKS_BEFORE_PARK {
+                idle_ticks = 0;
+                self.park();
+            } else {
+                std::thread::yield_now();
+            }
         }
+
+        self.exit();
+    }
+
+    /// Install this executor's context on the current thread
+    fn enter(&self) {
+        CONTEXT.with(|ctx| {
+            *ctx.borrow_mut() = Some(self.ctx.clone());
+        });
+        events::install_ring(self.events.clone());
+    }
+
+    /// Remove this executor's context from the current thread
+    fn exit(&self) {
+        CONTEXT.with(|ctx| {
+            *ctx.borrow_mut() = None;
+        });
+        events::clear_ring();
     }
 
     /// Execute one tick of the executor
+    ///
+    /// Returns `true` if a task was run.
     pub fn tick(&self) -> bool {
-        // Try to get a task from local queue
-        if let Some(runnable) = self.queue.pop() {
-            self.run_task(runnable);
-            return true;
+        // Fairness for cross-thread work: a busy worker whose slot/FIFO
+        // never drain would otherwise never reach the injector poll at
+        // the bottom of this function.
+        let count = self.tick_count.get().wrapping_add(1);
+        self.tick_count.set(count);
+        if count % GLOBAL_QUEUE_INTERVAL == 0 {
+            if let Steal::Success(runnable) = self
+                .ctx
+                .shared
+                .injector
+                .steal_batch_and_pop(&self.ctx.local)
+            {
+                self.stats.tasks_stolen.fetch_add(1, Ordering::Relaxed);
+                self.run_task(runnable);
+                return true;
+            }
         }
 
-        // Try to steal from global injector
-        if let Some(runnable) = self.injector.steal().success() {
+        // LIFO slot first: the freshest wake, hottest cache. Bounded:
+        // after MAX_LIFO_POLLS consecutive slot polls the occupant is
+        // demoted behind the FIFO queue, so a pair of tasks waking each
+        // other (or one self-waking) cannot starve queued work.
+        let streak = self.lifo_streak.get();
+        if streak < MAX_LIFO_POLLS {
+            if let Some(runnable) = self.ctx.lifo.take() {
+                self.lifo_streak.set(streak + 1);
+                self.run_task(runnable);
+                return true;
+            }
+        } else if let Some(runnable) = self.ctx.lifo.take() {
+            self.ctx.local.push(runnable);
+        }
+        self.lifo_streak.set(0);
+
+        // Then the local FIFO queue
+        if let Some(runnable) = self.ctx.local.pop() {
             self.run_task(runnable);
             return true;
         }
 
-        // Try to steal from other workers
+        // Refill from the injector: take a batch, run one
+        loop {
+            match self
+                .ctx
+                .shared
+                .injector
+                .steal_batch_and_pop(&self.ctx.local)
+            {
+                Steal::Success(runnable) => {
+                    self.stats.tasks_stolen.fetch_add(1, Ordering::Relaxed);
+                    self.run_task(runnable);
+                    return true;
+                }
+                Steal::Retry => continue,
+                Steal::Empty => break,
+            }
+        }
+
+        // Steal half a sibling's queue
         for stealer in &self.stealers {
-            if let Some(runnable) = stealer.steal().success() {
-                self.run_task(runnable);
-                return true;
+            loop {
+                match stealer.steal_batch_and_pop(&self.ctx.local) {
+                    Steal::Success(runnable) => {
+                        self.stats.tasks_stolen.fetch_add(1, Ordering::Relaxed);
+                        self.run_task(runnable);
+                        return true;
+                    }
+                    Steal::Retry => continue,
+                    Steal::Empty => break,
+                }
             }
         }
 
         false
     }
 
+    /// Park this worker until new work arrives
+    ///
+    /// Lost-wakeup safe: after registering, the injector is re-checked
+    /// and a sleeper is unparked if work raced in (possibly ourselves,
+    /// via the park token).
+    fn park(&self) {
+        if self.ctx.shared.is_shutdown() {
+            return;
+        }
+
+        self.stats.parks.fetch_add(1, Ordering::Relaxed);
+        self.ctx.shared.parked.lock().push(std::thread::current());
+
+        if !self.ctx.shared.injector.is_empty() {
+            self.ctx.shared.unpark_one();
+        }
+
+        // Tell the kernel this worker is elastic-idle: no hints, no
+        // escalation while parked (Delta #2 lifecycle machine).
+        let parked_scb = worker::try_current_scb().filter(|scb| {
+            scb.scb()
+                .worker_state
+                .compare_exchange(
+                    WorkerState::Running as u32,
+                    WorkerState::Parked as u32,
+                    Ordering::Release,
+                    Ordering::Relaxed,
+                )
+                .is_ok()
+        });
+
+        std::thread::park();
+
+        if let Some(scb) = parked_scb {
+            scb.scb()
+                .worker_state
+                .store(WorkerState::Running as u32, Ordering::Release);
+        }
+    }
+
     /// Run a single task, checking for yield requests
     fn run_task(&self, runnable: Runnable) {
         self.stats.polls.fetch_add(1, Ordering::Relaxed);
 
         // Check for kernel yield before polling
-        if self.should_yield() {
+        if let Some(reason) = self.should_yield() {
             // Re-queue the task and yield
-            self.queue.push(runnable);
-            self.acknowledge_yield();
+            self.ctx.local.push(runnable);
+            self.acknowledge_yield(reason);
             return;
         }
 
@@ -130,43 +440,63 @@ impl LocalExecutor {
         runnable.run();
     }
 
-    /// Check if we should yield before running a task
-    fn should_yield(&self) -> bool {
+    /// Check if we should yield before running a task, and why
+    fn should_yield(&self) -> Option<YieldReason> {
         // Never yield inside critical sections
         if in_critical_section() {
-            return false;
+            return None;
         }
 
         // Check defensive mode
         if self.defensive.should_yield() {
             self.stats.defensive_yields.fetch_add(1, Ordering::Relaxed);
-            return true;
+            return Some(YieldReason::Defensive);
         }
 
         // Check kernel yield request
         if let Some(scb) = worker::try_current_scb() {
             if scb.yield_requested() {
                 self.stats.kernel_yields.fetch_add(1, Ordering::Relaxed);
-                return true;
+                // Resolve the coalesced hint into the ledger category
+                let reason = match scb.pending_hint() {
+                    Some((HintReason::Budget, _)) => YieldReason::Budget,
+                    Some(_) => YieldReason::Hint,
+                    None => YieldReason::Checkpoint,
+                };
+                return Some(reason);
             }
         }
 
-        false
+        None
     }
 
-    /// Acknowledge a yield to the kernel
-    fn acknowledge_yield(&self) {
+    /// Acknowledge a yield to the kernel and record it in the event ring
+    fn acknowledge_yield(&self, reason: YieldReason) {
+        let mut pending_delta = 0;
+
         if let Some(scb) = worker::try_current_scb() {
+            let raw = scb.scb();
+            pending_delta = raw
+                .preempt_seq
+                .load(Ordering::Relaxed)
+                .saturating_sub(raw.last_ack_seq.load(Ordering::Relaxed));
+
+            // Delta #5 ledger: last reason plus the full event ring
+            raw.last_yield_reason.store(reason as u32, Ordering::Relaxed);
             scb.acknowledge();
+            crate::ringbuf::note_hint_ack();
         }
 
+        self.events
+            .record(reason, pending_delta, self.ctx.local.len() as u32);
+
         // Brief yield to allow other threads to run
         std::thread::yield_now();
     }
 
-    /// Request shutdown
+    /// Request shutdown of every worker sharing this runtime
     pub fn shutdown(&self) {
-        self.shutdown.store(true, Ordering::Release);
+        self.ctx.shared.shutdown();
     }
 
     /// Get executor statistics
@@ -204,18 +534,158 @@ impl Future for YieldNow {
 
 thread_local! {
     /// The current executor for this thread
-    static CURRENT_EXECUTOR: RefCell<Option<Arc<LocalExecutor>>> = const { RefCell::new(None) };
+    static CURRENT_EXECUTOR: RefCell<Option<Rc<LocalExecutor>>> = const { RefCell::new(None) };
 }
 
 /// Set the current executor for this thread
 #[allow(dead_code)]
-pub(crate) fn set_current_executor(executor: Arc<LocalExecutor>) {
+pub(crate) fn set_current_executor(executor: Rc<LocalExecutor>) {
     CURRENT_EXECUTOR.with(|e| {
         *e.borrow_mut() = Some(executor);
     });
 }
 
 /// Get the current executor
-pub fn current_executor() -> Option<Arc<LocalExecutor>> {
+pub fn current_executor() -> Option<Rc<LocalExecutor>> {
     CURRENT_EXECUTOR.with(|e| e.borrow().clone())
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::mpsc;
+    use std::time::Duration;
+
+    #[test]
+    fn test_spawn_runs_on_tick_not_inline() {
+        let shared = ExecutorShared::new();
+        let executor = LocalExecutor::new(shared, Vec::new(), Arc::new(DefensiveMode::new(0)));
+
+        let (tx, rx) = mpsc::channel();
+        let task = executor.spawn(async move {
+            tx.send(42).unwrap();
+        });
+        task.detach();
+
+        // Spawn must not run the future inline
+        assert!(rx.try_recv().is_err());
+
+        assert!(executor.tick());
+        assert_eq!(rx.try_recv().unwrap(), 42);
+    }
+
+    #[test]
+    fn test_rescheduled_task_lands_in_lifo_slot() {
+        let shared = ExecutorShared::new();
+        let executor = LocalExecutor::new(shared, Vec::new(), Arc::new(DefensiveMode::new(0)));
+        executor.enter();
+
+        let (tx, rx) = mpsc::channel();
+        let task = executor.spawn(async move {
+            yield_now().await;
+            tx.send(1).unwrap();
+        });
+        task.detach();
+
+        // First tick polls to the yield; the wake lands in the LIFO slot
+        assert!(executor.tick());
+        assert!(rx.try_recv().is_err());
+
+        // Second tick completes from the LIFO slot
+        assert!(executor.tick());
+        assert_eq!(rx.try_recv().unwrap(), 1);
+
+        executor.exit();
+    }
+
+    #[test]
+    fn test_off_worker_wake_goes_through_injector_and_unparks() {
+        let shared = ExecutorShared::new();
+        let (tx, rx) = mpsc::channel();
+
+        let worker_shared = shared.clone();
+        let handle = std::thread::spawn(move || {
+            let executor =
+                LocalExecutor::new(worker_shared, Vec::new(), Arc::new(DefensiveMode::new(0)));
+            executor.run();
+        });
+
+        // Spawned from a non-worker thread: injector + unpark
+        shared
+            .spawn(async move {
+                tx.send(7).unwrap();
+            })
+            .detach();
+
+        assert_eq!(
+            rx.recv_timeout(Duration::from_secs(5)).unwrap(),
+            7,
+            "parked worker should be woken for injected work"
+        );
+
+        shared.shutdown();
+        handle.join().unwrap();
+    }
+
+    #[test]
+    fn test_lifo_slot_cannot_starve_fifo() {
+        let shared = ExecutorShared::new();
+        let executor = LocalExecutor::new(shared, Vec::new(), Arc::new(DefensiveMode::new(0)));
+        executor.enter();
+
+        // A detached self-waking chain re-fills the LIFO slot forever
+        async fn chain() {
+            loop {
+                yield_now().await;
+            }
+        }
+        executor.spawn(chain()).detach();
+        // Drain the spawn from the FIFO so the chain lives in the slot
+        assert!(executor.tick());
+
+        // A queued task must still run within the LIFO poll bound
+        let (tx, rx) = mpsc::channel();
+        executor
+            .spawn(async move {
+                tx.send(5).unwrap();
+            })
+            .detach();
+
+        let mut ticks = 0;
+        while rx.try_recv().is_err() {
+            assert!(executor.tick());
+            ticks += 1;
+            assert!(
+                ticks <= 2 * MAX_LIFO_POLLS + 2,
+                "FIFO task starved by the LIFO slot"
+            );
+        }
+
+        executor.exit();
+    }
+
+    #[test]
+    fn test_sibling_stealing() {
+        let shared = ExecutorShared::new();
+        let victim = LocalExecutor::new(shared.clone(), Vec::new(), Arc::new(DefensiveMode::new(0)));
+        let thief = LocalExecutor::new(
+            shared,
+            vec![victim.stealer()],
+            Arc::new(DefensiveMode::new(0)),
+        );
+
+        let (tx, rx) = mpsc::channel();
+        for i in 0..4 {
+            let tx = tx.clone();
+            victim
+                .spawn(async move {
+                    tx.send(i).unwrap();
+                })
+                .detach();
+        }
+
+        // The thief's own queues are empty; it must steal from the victim
+        assert!(thief.tick());
+        assert!(rx.try_recv().is_ok());
+    }
+}
@@ -59,24 +59,28 @@ pub mod adapter;
 pub mod bpf_maps;
 pub mod critical;
 pub mod error;
+pub mod events;
 pub mod executor;
 pub mod metrics;
 pub mod ringbuf;
 pub mod runtime;
 pub mod scb;
+pub mod sim;
 pub mod worker;
 
 pub use adapter::{rust_adapter, LanguageAdapter, RustAdapter};
-pub use bpf_maps::BpfMaps;
-pub use critical::{critical_section, CriticalGuard};
+pub use bpf_maps::{BpfMaps, RegRegion};
+pub use critical::{critical_section, set_lazy_publication, CriticalGuard};
 pub use error::{Error, Result};
+pub use events::{YieldEvent, YieldEventRing};
+pub use ringbuf::{HintConsumer, HintConsumerThread, HintRingBuffer, HintRouter};
 pub use runtime::{Builder, Runtime};
-pub use scb::ScbHandle;
+pub use scb::{ReservationGuard, ScbHandle};
 
 /// Re-export common types including new architectural enums
 pub use morpheus_common::{
-    EscalationPolicy, GlobalPressure, HintReason, MorpheusHint, MorpheusScb, RuntimeMode,
-    SchedulerMode, WorkerState, YieldReason,
+    EscalationPolicy, GlobalPressure, HintReason, MorpheusHint, MorpheusRegSlot, MorpheusScb,
+    RegSlotState, RuntimeMode, SchedulerMode, WorkerState, YieldReason,
 };
 
 /// Check for pending kernel yield requests and yield if needed.
@@ -103,10 +107,9 @@ pub use morpheus_common::{
 #[macro_export]
 macro_rules! checkpoint {
     () => {{
-        if let Some(scb_handle) = $crate::worker::try_current_scb() {
-            if scb_handle.yield_requested() {
-                $crate::executor::yield_now().await;
-            }
+        if $crate::checkpoint_sync() {
+            $crate::events::record_checkpoint_yield();
+            $crate::executor::yield_now().await;
         }
     }};
 }
@@ -115,11 +118,12 @@ macro_rules! checkpoint {
 ///
 /// Returns `true` if a yield was requested, allowing the caller to decide
 /// how to respond.
+///
+/// The no-yield case compiles to a single relaxed load of `preempt_seq`
+/// through a raw TLS pointer, compared against a thread-local shadow of
+/// `last_ack_seq` - no Arc clone, no RefCell borrow, and a
+/// predicted-not-taken branch into the `#[cold]` slow path.
 #[inline]
 pub fn checkpoint_sync() -> bool {
-    if let Some(scb_handle) = worker::try_current_scb() {
-        scb_handle.yield_requested()
-    } else {
-        false
-    }
+    worker::fast_yield_check()
 }
@@ -5,31 +5,185 @@
 //! ## Metrics Exported
 //!
 //! - `morpheus_hint_count_total{worker_id, reason}` - Hints received
-//! - `morpheus_hint_drops_total` - Hints dropped (ring buffer full)  
+//! - `morpheus_hint_drops_total` - Hints dropped (ring buffer full)
 //! - `morpheus_escalation_count_total{policy}` - Escalations performed
 //! - `morpheus_defensive_mode_total{worker_id}` - Defensive mode activations
 //! - `morpheus_last_ack_latency_seconds{worker_id}` - Hint acknowledgment latency
+//!
+//! ## Design
+//!
+//! The hot path (`record_*`) is lock-free and allocation-free:
+//! fixed-shape per-worker atomic arrays indexed by the `HintReason` /
+//! `EscalationPolicy` discriminants, and a bounded log-linear histogram
+//! per worker for ack latency. Strings exist only at scrape time in
+//! `render()`.
 
-use std::collections::HashMap;
+use morpheus_common::{EscalationPolicy, HintReason, YieldReason};
 use std::sync::atomic::{AtomicU64, Ordering};
-use std::sync::RwLock;
+
+/// Reason slots: indices 0..=3 map HintReason 1..=4; 4 counts unknowns
+const REASON_SLOTS: usize = 5;
+/// Escalation policy slots (None/ThreadKick/CgroupThrottle/Hybrid)
+const POLICY_SLOTS: usize = 4;
+/// Default number of worker shards for the global registry - sized to
+/// the protocol maximum so no reachable worker id silently loses its
+/// per-worker series
+const DEFAULT_WORKERS: usize = morpheus_common::config::MAX_WORKERS as usize;
+
+/// Label names matching the reason slot indices
+const REASON_LABELS: [&str; REASON_SLOTS] =
+    ["budget", "pressure", "imbalance", "deadline", "unknown"];
+/// Label names matching the policy slot indices
+const POLICY_LABELS: [&str; POLICY_SLOTS] = ["none", "thread_kick", "cgroup_throttle", "hybrid"];
+
+/// Hint delivery stages traced by the span pipeline
+#[derive(Debug, Clone, Copy)]
+pub enum HintStage {
+    /// Kernel emission to consumer-thread receipt (ring buffer + wakeup)
+    EmitToReceive = 0,
+    /// Consumer receipt to worker acknowledgment (delivery + response)
+    ReceiveToAck = 1,
+    /// Full kernel-to-ack span
+    EmitToAck = 2,
+}
+
+const STAGE_SLOTS: usize = 3;
+const STAGE_LABELS: [&str; STAGE_SLOTS] = ["emit_to_receive", "receive_to_ack", "emit_to_ack"];
+
+/// Yield reason slots (YieldReason discriminants 0..=5)
+const YIELD_SLOTS: usize = 6;
+/// Label names matching the yield reason slot indices
+const YIELD_LABELS: [&str; YIELD_SLOTS] = [
+    "none",
+    "hint",
+    "checkpoint",
+    "budget",
+    "defensive",
+    "escalation_recovery",
+];
+
+/// Sub-bucket bits per power of two in the latency histogram
+const HIST_SUB_BITS: u32 = 2;
+const HIST_SUB: u32 = 1 << HIST_SUB_BITS;
+/// Powers of two covered (2^0 .. 2^31 ns, ~2.1s)
+const HIST_MAJORS: u32 = 32;
+const HIST_BUCKETS: usize = (HIST_MAJORS * HIST_SUB) as usize;
+
+/// Bounded log-linear latency histogram
+///
+/// 128 buckets spanning 1ns..~2.1s with 4 sub-buckets per power of two
+/// (~25% relative error). Recording is one atomic increment; percentile
+/// extraction walks the buckets at scrape time.
+pub struct LogHistogram {
+    buckets: [AtomicU64; HIST_BUCKETS],
+    count: AtomicU64,
+    sum: AtomicU64,
+}
+
+impl Default for LogHistogram {
+    fn default() -> Self {
+        Self {
+            buckets: std::array::from_fn(|_| AtomicU64::new(0)),
+            count: AtomicU64::new(0),
+            sum: AtomicU64::new(0),
+        }
+    }
+}
+
+impl LogHistogram {
+    fn bucket_index(value_ns: u64) -> usize {
+        let value = value_ns.max(1);
+        let major = 63 - value.leading_zeros() as u64;
+        if major == 0 {
+            return 0;
+        }
+        let major = (major as u32).min(HIST_MAJORS - 1);
+        // Top HIST_SUB_BITS bits below the leading one select the sub-bucket
+        let sub = ((value >> major.saturating_sub(HIST_SUB_BITS)) as u32) & (HIST_SUB - 1);
+        ((major * HIST_SUB) + sub) as usize
+    }
+
+    /// Upper bound (ns) of a bucket, for percentile reporting
+    fn bucket_bound(index: usize) -> u64 {
+        let major = (index as u32) / HIST_SUB;
+        let sub = (index as u32) % HIST_SUB;
+        if major == 0 {
+            return 1;
+        }
+        (1u64 << major) + (((sub + 1) as u64) << major.saturating_sub(HIST_SUB_BITS))
+    }
+
+    /// Record a sample (lock-free, allocation-free)
+    #[inline]
+    pub fn record(&self, value_ns: u64) {
+        self.buckets[Self::bucket_index(value_ns)].fetch_add(1, Ordering::Relaxed);
+        self.count.fetch_add(1, Ordering::Relaxed);
+        self.sum.fetch_add(value_ns, Ordering::Relaxed);
+    }
+
+    /// Total samples recorded
+    pub fn count(&self) -> u64 {
+        self.count.load(Ordering::Relaxed)
+    }
+
+    /// Sum of all samples in nanoseconds
+    pub fn sum_ns(&self) -> u64 {
+        self.sum.load(Ordering::Relaxed)
+    }
+
+    /// Extract a percentile (0.0-100.0), or None if empty
+    pub fn percentile(&self, p: f64) -> Option<u64> {
+        let total = self.count();
+        if total == 0 {
+            return None;
+        }
+
+        let target = ((total as f64) * p / 100.0).ceil().max(1.0) as u64;
+        let mut seen = 0u64;
+        for (index, bucket) in self.buckets.iter().enumerate() {
+            seen += bucket.load(Ordering::Relaxed);
+            if seen >= target {
+                return Some(Self::bucket_bound(index));
+            }
+        }
+        Some(Self::bucket_bound(HIST_BUCKETS - 1))
+    }
+}
+
+/// Per-worker metric shard: fixed-shape, all atomics
+#[derive(Default)]
+struct WorkerMetrics {
+    hint_counts: [AtomicU64; REASON_SLOTS],
+    defensive_activations: AtomicU64,
+    ack_latency: LogHistogram,
+}
 
 /// Metrics collector for Morpheus runtime
+///
+/// All `record_*` methods are lock-free and allocation-free; they index
+/// flat atomic arrays by worker id and enum discriminant. `render()`
+/// (scrape time) is the only place strings are built.
 pub struct MorpheusMetrics {
-    /// Total hints received per worker, per reason
-    hint_counts: RwLock<HashMap<(u32, String), AtomicU64>>,
+    /// Per-worker shards, indexed by worker_id
+    workers: Box<[WorkerMetrics]>,
 
     /// Total hints dropped (ring buffer overflow)
     hint_drops: AtomicU64,
 
     /// Total escalations per policy
-    escalation_counts: RwLock<HashMap<String, AtomicU64>>,
+    escalation_counts: [AtomicU64; POLICY_SLOTS],
 
-    /// Defensive mode activations per worker
-    defensive_mode_counts: RwLock<HashMap<u32, AtomicU64>>,
+    /// Records discarded because the worker id exceeded the shard count
+    /// (visible in the export so truncation is never silent)
+    dropped_records: AtomicU64,
 
-    /// Acknowledgment latency samples per worker (in nanoseconds)
-    ack_latency_samples: RwLock<HashMap<u32, Vec<u64>>>,
+    /// Latency-between-yields per yield reason (fed from the per-worker
+    /// event rings, aggregated across workers)
+    yield_intervals: [LogHistogram; YIELD_SLOTS],
+
+    /// Per-stage hint delivery latency (sampled spans from the tracing
+    /// pipeline; the ring buffer's own sampling bounds the rate)
+    hint_stages: [LogHistogram; STAGE_SLOTS],
 }
 
 impl Default for MorpheusMetrics {
@@ -39,80 +193,136 @@ impl Default for MorpheusMetrics {
 }
 
 impl MorpheusMetrics {
-    /// Create a new metrics collector
+    /// Create a metrics collector sized for the default worker count
     pub fn new() -> Self {
+        Self::with_capacity(DEFAULT_WORKERS)
+    }
+
+    /// Create a metrics collector with shards for `num_workers` workers
+    pub fn with_capacity(num_workers: usize) -> Self {
         Self {
-            hint_counts: RwLock::new(HashMap::new()),
+            workers: (0..num_workers).map(|_| WorkerMetrics::default()).collect(),
             hint_drops: AtomicU64::new(0),
-            escalation_counts: RwLock::new(HashMap::new()),
-            defensive_mode_counts: RwLock::new(HashMap::new()),
-            ack_latency_samples: RwLock::new(HashMap::new()),
+            escalation_counts: std::array::from_fn(|_| AtomicU64::new(0)),
+            dropped_records: AtomicU64::new(0),
+            yield_intervals: std::array::from_fn(|_| LogHistogram::default()),
+            hint_stages: std::array::from_fn(|_| LogHistogram::default()),
+        }
+    }
+
+    #[inline]
+    fn worker(&self, worker_id: u32) -> Option<&WorkerMetrics> {
+        let worker = self.workers.get(worker_id as usize);
+        if worker.is_none() {
+            self.dropped_records.fetch_add(1, Ordering::Relaxed);
         }
+        worker
     }
 
     /// Record a hint received
-    pub fn record_hint(&self, worker_id: u32, reason: &str) {
-        let mut counts = self.hint_counts.write().unwrap();
-        let key = (worker_id, reason.to_string());
-        counts
-            .entry(key)
-            .or_insert_with(|| AtomicU64::new(0))
-            .fetch_add(1, Ordering::Relaxed);
+    ///
+    /// `None` counts under the "unknown" reason label.
+    #[inline]
+    pub fn record_hint(&self, worker_id: u32, reason: Option<HintReason>) {
+        let slot = match reason {
+            Some(reason) => reason as usize - 1,
+            None => REASON_SLOTS - 1,
+        };
+        if let Some(worker) = self.worker(worker_id) {
+            worker.hint_counts[slot].fetch_add(1, Ordering::Relaxed);
+        }
     }
 
     /// Record a hint drop
+    #[inline]
     pub fn record_hint_drop(&self) {
         self.hint_drops.fetch_add(1, Ordering::Relaxed);
     }
 
     /// Record an escalation
-    pub fn record_escalation(&self, policy: &str) {
-        let mut counts = self.escalation_counts.write().unwrap();
-        counts
-            .entry(policy.to_string())
-            .or_insert_with(|| AtomicU64::new(0))
-            .fetch_add(1, Ordering::Relaxed);
+    #[inline]
+    pub fn record_escalation(&self, policy: EscalationPolicy) {
+        self.escalation_counts[policy as usize].fetch_add(1, Ordering::Relaxed);
     }
 
     /// Record defensive mode activation
+    #[inline]
     pub fn record_defensive_mode(&self, worker_id: u32) {
-        let mut counts = self.defensive_mode_counts.write().unwrap();
-        counts
-            .entry(worker_id)
-            .or_insert_with(|| AtomicU64::new(0))
-            .fetch_add(1, Ordering::Relaxed);
+        if let Some(worker) = self.worker(worker_id) {
+            worker.defensive_activations.fetch_add(1, Ordering::Relaxed);
+        }
     }
 
     /// Record acknowledgment latency sample
+    #[inline]
     pub fn record_ack_latency(&self, worker_id: u32, latency_ns: u64) {
-        let mut samples = self.ack_latency_samples.write().unwrap();
-        let worker_samples = samples.entry(worker_id).or_default();
-
-        // Keep last 1000 samples per worker
-        if worker_samples.len() >= 1000 {
-            worker_samples.remove(0);
+        if let Some(worker) = self.worker(worker_id) {
+            worker.ack_latency.record(latency_ns);
         }
-        worker_samples.push(latency_ns);
+    }
+
+    /// Record the gap between consecutive yields, attributed to the
+    /// reason of the later yield
+    #[inline]
+    pub fn record_yield_interval(&self, reason: YieldReason, interval_ns: u64) {
+        self.yield_intervals[reason as usize].record(interval_ns);
+    }
+
+    /// Record one stage of a traced hint's delivery span
+    #[inline]
+    pub fn record_hint_stage(&self, stage: HintStage, latency_ns: u64) {
+        self.hint_stages[stage as usize].record(latency_ns);
+    }
+
+    /// Extract an ack-latency percentile for a worker (0.0-100.0)
+    pub fn ack_latency_percentile(&self, worker_id: u32, p: f64) -> Option<u64> {
+        self.worker(worker_id)?.ack_latency.percentile(p)
     }
 
     /// Render metrics in Prometheus text format
+    ///
+    /// Convenience wrapper allocating a fresh buffer; scrape handlers
+    /// should hold a preallocated String and use
+    /// [`render_into`](Self::render_into) instead.
     pub fn render(&self) -> String {
         let mut output = String::new();
+        self.render_into(&mut output);
+        output
+    }
+
+    /// Render metrics into a reusable buffer, allocation-free at steady
+    /// state
+    ///
+    /// Clears `output` and appends the full exposition. After the first
+    /// scrape the buffer's capacity is retained, so subsequent scrapes
+    /// do no allocation (beyond growth when new series appear) and take
+    /// no lock any hot path contends on - all reads are relaxed atomic
+    /// loads.
+    pub fn render_into(&self, output: &mut String) {
+        use std::fmt::Write as _;
+
+        // Pull the per-worker yield event rings into this registry so
+        // the interval-per-reason series are current at every scrape.
+        crate::events::drain_registered_rings(self);
+
+        output.clear();
 
         // Hint counts
         output.push_str(
             "# HELP morpheus_hint_count_total Total hints received by worker and reason\n",
         );
         output.push_str("# TYPE morpheus_hint_count_total counter\n");
-        {
-            let counts = self.hint_counts.read().unwrap();
-            for ((worker_id, reason), count) in counts.iter() {
-                output.push_str(&format!(
+        for (worker_id, worker) in self.workers.iter().enumerate() {
+            for (slot, label) in REASON_LABELS.iter().enumerate() {
+                let count = worker.hint_counts[slot].load(Ordering::Relaxed);
+                if count == 0 {
+                    continue;
+                }
+                let _ = write!(
+                    output,
                     "morpheus_hint_count_total{{worker_id=\"{}\",reason=\"{}\"}} {}\n",
-                    worker_id,
-                    reason,
-                    count.load(Ordering::Relaxed)
-                ));
+                    worker_id, label, count
+                );
             }
         }
 
@@ -121,23 +331,37 @@ impl MorpheusMetrics {
             "# HELP morpheus_hint_drops_total Total hints dropped due to ring buffer overflow\n",
         );
         output.push_str("# TYPE morpheus_hint_drops_total counter\n");
-        output.push_str(&format!(
+        let _ = write!(
+            output,
             "morpheus_hint_drops_total {}\n",
             self.hint_drops.load(Ordering::Relaxed)
-        ));
+        );
+
+        // Out-of-range discards (should stay zero; nonzero means a
+        // registry sized below the ids actually in use)
+        output.push_str(
+            "# HELP morpheus_metrics_dropped_records_total Records discarded for out-of-range worker ids\n",
+        );
+        output.push_str("# TYPE morpheus_metrics_dropped_records_total counter\n");
+        let _ = write!(
+            output,
+            "morpheus_metrics_dropped_records_total {}\n",
+            self.dropped_records.load(Ordering::Relaxed)
+        );
 
         // Escalation counts
         output.push_str("# HELP morpheus_escalation_count_total Total escalations by policy\n");
         output.push_str("# TYPE morpheus_escalation_count_total counter\n");
-        {
-            let counts = self.escalation_counts.read().unwrap();
-            for (policy, count) in counts.iter() {
-                output.push_str(&format!(
-                    "morpheus_escalation_count_total{{policy=\"{}\"}} {}\n",
-                    policy,
-                    count.load(Ordering::Relaxed)
-                ));
+        for (slot, label) in POLICY_LABELS.iter().enumerate() {
+            let count = self.escalation_counts[slot].load(Ordering::Relaxed);
+            if count == 0 {
+                continue;
             }
+            let _ = write!(
+                output,
+                "morpheus_escalation_count_total{{policy=\"{}\"}} {}\n",
+                label, count
+            );
         }
 
         // Defensive mode counts
@@ -145,69 +369,111 @@ impl MorpheusMetrics {
             "# HELP morpheus_defensive_mode_total Defensive mode activations by worker\n",
         );
         output.push_str("# TYPE morpheus_defensive_mode_total counter\n");
-        {
-            let counts = self.defensive_mode_counts.read().unwrap();
-            for (worker_id, count) in counts.iter() {
-                output.push_str(&format!(
-                    "morpheus_defensive_mode_total{{worker_id=\"{}\"}} {}\n",
-                    worker_id,
-                    count.load(Ordering::Relaxed)
-                ));
+        for (worker_id, worker) in self.workers.iter().enumerate() {
+            let count = worker.defensive_activations.load(Ordering::Relaxed);
+            if count == 0 {
+                continue;
             }
+            let _ = write!(
+                output,
+                "morpheus_defensive_mode_total{{worker_id=\"{}\"}} {}\n",
+                worker_id, count
+            );
         }
 
-        // Ack latency histogram
+        // Ack latency summaries (percentiles from the log-linear histogram)
         output.push_str(
             "# HELP morpheus_last_ack_latency_seconds Hint acknowledgment latency in seconds\n",
         );
-        output.push_str("# TYPE morpheus_last_ack_latency_seconds histogram\n");
-        {
-            let samples = self.ack_latency_samples.read().unwrap();
-            for (worker_id, worker_samples) in samples.iter() {
-                if worker_samples.is_empty() {
-                    continue;
-                }
+        output.push_str("# TYPE morpheus_last_ack_latency_seconds summary\n");
+        for (worker_id, worker) in self.workers.iter().enumerate() {
+            let hist = &worker.ack_latency;
+            if hist.count() == 0 {
+                continue;
+            }
 
-                // Calculate histogram buckets (in seconds)
-                let buckets = [0.00001, 0.00005, 0.0001, 0.0005, 0.001, 0.005, 0.01];
-                let mut bucket_counts = vec![0u64; buckets.len()];
-                let mut sum_ns: u64 = 0;
-
-                for &sample_ns in worker_samples.iter() {
-                    sum_ns = sum_ns.saturating_add(sample_ns);
-                    let sample_s = sample_ns as f64 / 1_000_000_000.0;
-                    for (i, &bucket) in buckets.iter().enumerate() {
-                        if sample_s <= bucket {
-                            bucket_counts[i] += 1;
-                        }
-                    }
+            for (quantile, p) in [("0.5", 50.0), ("0.99", 99.0), ("0.999", 99.9)] {
+                if let Some(bound_ns) = hist.percentile(p) {
+                    let _ = write!(
+                        output,
+                        "morpheus_last_ack_latency_seconds{{worker_id=\"{}\",quantile=\"{}\"}} {}\n",
+                        worker_id,
+                        quantile,
+                        bound_ns as f64 / 1_000_000_000.0
+                    );
                 }
+            }
+            let _ = write!(
+                output,
+                "morpheus_last_ack_latency_seconds_sum{{worker_id=\"{}\"}} {}\n",
+                worker_id,
+                hist.sum_ns() as f64 / 1_000_000_000.0
+            );
+            let _ = write!(
+                output,
+                "morpheus_last_ack_latency_seconds_count{{worker_id=\"{}\"}} {}\n",
+                worker_id,
+                hist.count()
+            );
+        }
 
-                for (i, &bucket) in buckets.iter().enumerate() {
-                    output.push_str(&format!(
-                        "morpheus_last_ack_latency_seconds_bucket{{worker_id=\"{}\",le=\"{}\"}} {}\n",
-                        worker_id, bucket, bucket_counts[i]
-                    ));
+        // Hint delivery stage latencies (sampled spans)
+        output.push_str(
+            "# HELP morpheus_hint_stage_seconds Per-stage hint delivery latency (sampled)\n",
+        );
+        output.push_str("# TYPE morpheus_hint_stage_seconds summary\n");
+        for (slot, label) in STAGE_LABELS.iter().enumerate() {
+            let hist = &self.hint_stages[slot];
+            if hist.count() == 0 {
+                continue;
+            }
+            for (quantile, p) in [("0.5", 50.0), ("0.99", 99.0), ("0.999", 99.9)] {
+                if let Some(bound_ns) = hist.percentile(p) {
+                    let _ = write!(
+                        output,
+                        "morpheus_hint_stage_seconds{{stage=\"{}\",quantile=\"{}\"}} {}\n",
+                        label,
+                        quantile,
+                        bound_ns as f64 / 1_000_000_000.0
+                    );
                 }
-                output.push_str(&format!(
-                    "morpheus_last_ack_latency_seconds_bucket{{worker_id=\"{}\",le=\"+Inf\"}} {}\n",
-                    worker_id,
-                    worker_samples.len()
-                ));
-                output.push_str(&format!(
-                    "morpheus_last_ack_latency_seconds_sum{{worker_id=\"{}\"}} {}\n",
-                    worker_id,
-                    sum_ns as f64 / 1_000_000_000.0
-                ));
-                output.push_str(&format!(
-                    "morpheus_last_ack_latency_seconds_count{{worker_id=\"{}\"}} {}\n",
-                    worker_id,
-                    worker_samples.len()
-                ));
             }
+            let _ = write!(
+                output,
+                "morpheus_hint_stage_seconds_count{{stage=\"{}\"}} {}\n",
+                label,
+                hist.count()
+            );
         }
 
-        output
+        // Inter-yield latency per yield reason
+        output.push_str(
+            "# HELP morpheus_yield_interval_seconds Time between consecutive yields by reason\n",
+        );
+        output.push_str("# TYPE morpheus_yield_interval_seconds summary\n");
+        for (slot, label) in YIELD_LABELS.iter().enumerate() {
+            let hist = &self.yield_intervals[slot];
+            if hist.count() == 0 {
+                continue;
+            }
+            for (quantile, p) in [("0.5", 50.0), ("0.99", 99.0), ("0.999", 99.9)] {
+                if let Some(bound_ns) = hist.percentile(p) {
+                    let _ = write!(
+                        output,
+                        "morpheus_yield_interval_seconds{{reason=\"{}\",quantile=\"{}\"}} {}\n",
+                        label,
+                        quantile,
+                        bound_ns as f64 / 1_000_000_000.0
+                    );
+                }
+            }
+            let _ = write!(
+                output,
+                "morpheus_yield_interval_seconds_count{{reason=\"{}\"}} {}\n",
+                label,
+                hist.count()
+            );
+        }
     }
 }
 
@@ -227,19 +493,69 @@ mod tests {
     fn test_metrics_recording() {
         let m = MorpheusMetrics::new();
 
-        m.record_hint(0, "budget");
-        m.record_hint(0, "budget");
-        m.record_hint(1, "pressure");
+        m.record_hint(0, Some(HintReason::Budget));
+        m.record_hint(0, Some(HintReason::Budget));
+        m.record_hint(1, Some(HintReason::Pressure));
+        m.record_hint(2, None);
         m.record_hint_drop();
-        m.record_escalation("thread_kick");
+        m.record_escalation(EscalationPolicy::ThreadKick);
         m.record_defensive_mode(0);
         m.record_ack_latency(0, 50_000); // 50µs
 
         let output = m.render();
-        assert!(output.contains("morpheus_hint_count_total"));
-        assert!(output.contains("morpheus_hint_drops_total"));
-        assert!(output.contains("morpheus_escalation_count_total"));
-        assert!(output.contains("morpheus_defensive_mode_total"));
-        assert!(output.contains("morpheus_last_ack_latency_seconds"));
+        assert!(output.contains("morpheus_hint_count_total{worker_id=\"0\",reason=\"budget\"} 2"));
+        assert!(output.contains("reason=\"unknown\"} 1"));
+        assert!(output.contains("morpheus_hint_drops_total 1"));
+        assert!(output.contains("policy=\"thread_kick\"} 1"));
+        assert!(output.contains("morpheus_defensive_mode_total{worker_id=\"0\"} 1"));
+        assert!(output.contains("morpheus_last_ack_latency_seconds_count{worker_id=\"0\"} 1"));
+    }
+
+    #[test]
+    fn test_out_of_range_worker_is_counted() {
+        let m = MorpheusMetrics::with_capacity(4);
+        m.record_hint(1000, Some(HintReason::Budget));
+        m.record_ack_latency(1000, 1);
+        let output = m.render();
+        assert!(!output.contains("worker_id=\"1000\""));
+        assert!(output.contains("morpheus_metrics_dropped_records_total 2"));
+    }
+
+    #[test]
+    fn test_default_registry_covers_max_workers() {
+        let m = MorpheusMetrics::new();
+        let last = morpheus_common::config::MAX_WORKERS - 1;
+        m.record_hint(last, Some(HintReason::Budget));
+        assert!(m
+            .render()
+            .contains(&format!("worker_id=\"{}\"", last)));
+    }
+
+    #[test]
+    fn test_histogram_percentiles_bounded_error() {
+        let hist = LogHistogram::default();
+        for _ in 0..90 {
+            hist.record(1_000);
+        }
+        for _ in 0..10 {
+            hist.record(1_000_000);
+        }
+
+        let p50 = hist.percentile(50.0).unwrap();
+        assert!((1_000..=1_500).contains(&p50), "p50={}", p50);
+
+        let p99 = hist.percentile(99.0).unwrap();
+        assert!((1_000_000..=1_500_000).contains(&p99), "p99={}", p99);
+
+        assert_eq!(hist.count(), 100);
+    }
+
+    #[test]
+    fn test_histogram_extremes() {
+        let hist = LogHistogram::default();
+        hist.record(0);
+        hist.record(u64::MAX);
+        assert_eq!(hist.count(), 2);
+        assert!(hist.percentile(100.0).is_some());
     }
 }
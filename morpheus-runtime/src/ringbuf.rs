@@ -2,8 +2,18 @@
 //!
 //! Consumes yield hints from the kernel via the BPF ring buffer.
 //! Detects overflow conditions and triggers defensive mode.
+//!
+//! The delivery path is a dedicated epoll-driven thread
+//! ([`HintConsumerThread`]) blocked on the ring buffer fd: zero wakeups
+//! while idle, batch-draining when the kernel signals, and per-worker
+//! routing of each hint by `target_tid` through a [`HintRouter`] so a
+//! hint for worker 3 wakes worker 3 instead of flipping global state.
 
+use crate::error::{Error, Result};
 use morpheus_common::{HintReason, MorpheusHint};
+use parking_lot::RwLock;
+use std::collections::HashMap;
+use std::os::fd::{AsFd, AsRawFd, BorrowedFd, FromRawFd, OwnedFd};
 use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::Arc;
 use tracing::{debug, warn};
@@ -30,15 +40,28 @@ pub struct HintConsumer {
     defensive_mode: Arc<AtomicBool>,
     /// Statistics
     stats: Arc<RingBufStats>,
+    /// Scheduler-side ring buffer sampling interval (1 = every hint).
+    /// Sequence gaps up to this size are expected, not drops.
+    sample_interval: u64,
 }
 
 impl HintConsumer {
-    /// Create a new hint consumer
+    /// Create a new hint consumer (assumes an unsampled hint stream)
     pub fn new() -> Self {
+        Self::with_sample_interval(1)
+    }
+
+    /// Create a hint consumer for a sampled hint stream
+    ///
+    /// Pass the scheduler's `--hint-sample` value. With coalesced SCB
+    /// delivery the ring buffer only carries every Nth hint, so gap
+    /// detection must not treat the expected stride as loss.
+    pub fn with_sample_interval(sample_interval: u64) -> Self {
         Self {
             last_seq: AtomicU64::new(0),
             defensive_mode: Arc::new(AtomicBool::new(false)),
             stats: Arc::new(RingBufStats::default()),
+            sample_interval: sample_interval.max(1),
         }
     }
 
@@ -71,10 +94,11 @@ impl HintConsumer {
 
         self.stats.hints_received.fetch_add(1, Ordering::Relaxed);
 
-        // Check for sequence gaps (indicates dropped hints)
+        // Check for sequence gaps (indicates dropped hints). Gaps up to
+        // the sampling interval are the expected stride of a sampled stream.
         let last = self.last_seq.load(Ordering::Relaxed);
-        if hint.seq > last + 1 && last > 0 {
-            let dropped = hint.seq - last - 1;
+        if hint.seq > last + self.sample_interval && last > 0 {
+            let dropped = hint.seq - last - self.sample_interval;
             self.stats
                 .hints_dropped
                 .fetch_add(dropped, Ordering::Relaxed);
@@ -183,3 +207,591 @@ impl Default for DefensiveMode {
         Self::new(100) // Default: 100 forced yields
     }
 }
+
+/// Read CLOCK_MONOTONIC in nanoseconds
+///
+/// Comparable with the kernel's `bpf_ktime_get_ns()` stamps, which is
+/// what makes cross-boundary hint spans possible.
+pub fn monotonic_ns() -> u64 {
+    let mut ts = libc::timespec {
+        tv_sec: 0,
+        tv_nsec: 0,
+    };
+    unsafe { libc::clock_gettime(libc::CLOCK_MONOTONIC, &mut ts) };
+    (ts.tv_sec as u64) * 1_000_000_000 + ts.tv_nsec as u64
+}
+
+/// Per-worker hint state: the pending flag plus the traced span stamps
+///
+/// The consumer thread writes `seq`/`emit_ns`/`receive_ns` when routing
+/// a (sampled) hint; the worker reads them when it acknowledges, closing
+/// the receive->ack and emit->ack spans.
+#[derive(Default)]
+pub struct HintFlag {
+    /// A hint for this worker is pending
+    pub pending: AtomicBool,
+    /// Sequence number of the traced hint
+    pub seq: AtomicU64,
+    /// Kernel emission stamp (CLOCK_MONOTONIC ns; 0 = no traced span)
+    pub emit_ns: AtomicU64,
+    /// Consumer receipt stamp (CLOCK_MONOTONIC ns)
+    pub receive_ns: AtomicU64,
+}
+
+/// Per-worker hint routing table
+///
+/// Maps a worker TID to its hint state. The consumer thread sets the
+/// state of exactly the worker a hint targets; the worker clears it at
+/// its next acknowledgment. Lookups on the hot path take a read lock
+/// and allocate nothing; registration (the only writer) is rare.
+#[derive(Default)]
+pub struct HintRouter {
+    flags: RwLock<HashMap<u32, Arc<HintFlag>>>,
+}
+
+impl HintRouter {
+    /// Create an empty router
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Register a worker TID, returning its hint state
+    ///
+    /// Workers should install the returned handle on their own thread
+    /// with [`install_hint_flag`] so acknowledgments close the spans.
+    pub fn register(&self, tid: u32) -> Arc<HintFlag> {
+        let flag = Arc::new(HintFlag::default());
+        self.flags.write().insert(tid, flag.clone());
+        flag
+    }
+
+    /// Remove a worker TID from the routing table
+    pub fn unregister(&self, tid: u32) {
+        self.flags.write().remove(&tid);
+    }
+
+    /// Route a hint to its target worker, stamping the traced span
+    ///
+    /// Returns `true` if the TID was registered.
+    pub fn route(&self, hint: &MorpheusHint, receive_ns: u64) -> bool {
+        if let Some(flag) = self.flags.read().get(&hint.target_tid) {
+            flag.seq.store(hint.seq, Ordering::Relaxed);
+            flag.emit_ns.store(hint.emit_ns, Ordering::Relaxed);
+            flag.receive_ns.store(receive_ns, Ordering::Relaxed);
+            flag.pending.store(true, Ordering::Release);
+            true
+        } else {
+            false
+        }
+    }
+}
+
+thread_local! {
+    /// The hint state of the current worker thread, if registered
+    static HINT_FLAG: std::cell::RefCell<Option<Arc<HintFlag>>> =
+        const { std::cell::RefCell::new(None) };
+}
+
+/// Install the current worker's hint state (from [`HintRouter::register`])
+pub fn install_hint_flag(flag: Arc<HintFlag>) {
+    HINT_FLAG.with(|f| *f.borrow_mut() = Some(flag));
+}
+
+/// Remove the current thread's hint state
+pub fn clear_hint_flag() {
+    HINT_FLAG.with(|f| *f.borrow_mut() = None);
+}
+
+/// Close the traced span for the current worker's pending hint, if any
+///
+/// Called from the acknowledgment paths (cold): records receive->ack
+/// and emit->ack into the global metrics. A no-op when no sampled hint
+/// is pending, so the cost never reaches the no-yield fast path.
+pub fn note_hint_ack() {
+    HINT_FLAG.with(|f| {
+        if let Some(flag) = f.borrow().as_ref() {
+            if flag.pending.swap(false, Ordering::AcqRel) {
+                let now = monotonic_ns();
+                let emit = flag.emit_ns.load(Ordering::Relaxed);
+                let receive = flag.receive_ns.load(Ordering::Relaxed);
+
+                let metrics = crate::metrics::metrics();
+                if receive > 0 && now > receive {
+                    metrics.record_hint_stage(
+                        crate::metrics::HintStage::ReceiveToAck,
+                        now - receive,
+                    );
+                }
+                if emit > 0 && now > emit {
+                    metrics
+                        .record_hint_stage(crate::metrics::HintStage::EmitToAck, now - emit);
+                }
+            }
+        }
+    });
+}
+
+/// BPF ring buffer record header flags (uapi)
+const RINGBUF_BUSY_BIT: u32 = 1 << 31;
+const RINGBUF_DISCARD_BIT: u32 = 1 << 30;
+/// Record header size in bytes
+const RINGBUF_HDR_SZ: u64 = 8;
+
+/// Raw consumer for a BPF ring buffer map
+///
+/// Implements the kernel's ring buffer mmap ABI directly (consumer page
+/// read-write, producer page + double-mapped data read-only) so the
+/// runtime can drain hints without linking libbpf. The map fd is
+/// registered in an epoll set together with a shutdown eventfd, so the
+/// consumer thread costs nothing while the ring is quiet.
+pub struct HintRingBuffer {
+    map_fd: OwnedFd,
+    epoll_fd: OwnedFd,
+    shutdown_fd: OwnedFd,
+    /// rw mapping of the consumer position page
+    consumer: *mut u64,
+    /// ro mapping: producer position page followed by 2x data
+    producer: *const u64,
+    data: *const u8,
+    /// ring size - 1 (size is a power of two)
+    mask: u64,
+    /// Kept to unmap on drop
+    consumer_len: usize,
+    producer_len: usize,
+}
+
+// The raw pointers reference shared kernel memory accessed with
+// volatile/atomic discipline by a single consumer thread.
+unsafe impl Send for HintRingBuffer {}
+
+impl HintRingBuffer {
+    /// Build a consumer over the ring buffer pinned by the scheduler
+    ///
+    /// The loader pins `hint_ringbuf` under its `--pin-maps` directory
+    /// (default `/sys/fs/bpf/morpheus/hint_ringbuf`); this is how
+    /// out-of-process runtimes obtain the fd.
+    pub fn from_pinned_path(ringbuf_path: &str) -> Result<Self> {
+        let fd = crate::bpf_maps::BpfMaps::bpf_obj_get(ringbuf_path).map_err(|e| {
+            Error::RingBuffer(format!(
+                "failed to open hint_ringbuf at {}: {}",
+                ringbuf_path, e
+            ))
+        })?;
+        Self::from_map_fd(fd.as_fd())
+    }
+
+    /// Build a consumer over a BPF_MAP_TYPE_RINGBUF map fd
+    ///
+    /// The fd is duplicated; the caller keeps ownership of its copy.
+    pub fn from_map_fd(map_fd: BorrowedFd<'_>) -> Result<Self> {
+        let dup = unsafe { libc::dup(map_fd.as_raw_fd()) };
+        if dup < 0 {
+            return Err(Error::RingBuffer(format!(
+                "dup failed: {}",
+                std::io::Error::last_os_error()
+            )));
+        }
+        let map_fd = unsafe { OwnedFd::from_raw_fd(dup) };
+
+        let size = Self::ring_size(&map_fd)?;
+        let page_size = unsafe { libc::sysconf(libc::_SC_PAGESIZE) } as usize;
+
+        // Consumer page: read-write
+        let consumer_len = page_size;
+        let consumer = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                consumer_len,
+                libc::PROT_READ | libc::PROT_WRITE,
+                libc::MAP_SHARED,
+                map_fd.as_raw_fd(),
+                0,
+            )
+        };
+        if consumer == libc::MAP_FAILED {
+            return Err(Error::RingBuffer(format!(
+                "consumer mmap failed: {}",
+                std::io::Error::last_os_error()
+            )));
+        }
+
+        // Producer page + double-mapped data: read-only
+        let producer_len = page_size + 2 * size as usize;
+        let producer = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                producer_len,
+                libc::PROT_READ,
+                libc::MAP_SHARED,
+                map_fd.as_raw_fd(),
+                page_size as i64,
+            )
+        };
+        if producer == libc::MAP_FAILED {
+            let err = std::io::Error::last_os_error();
+            unsafe { libc::munmap(consumer, consumer_len) };
+            return Err(Error::RingBuffer(format!("data mmap failed: {}", err)));
+        }
+
+        // Epoll set: ring fd for data, eventfd for shutdown
+        let epoll = unsafe { libc::epoll_create1(libc::EPOLL_CLOEXEC) };
+        if epoll < 0 {
+            return Err(Error::RingBuffer(format!(
+                "epoll_create1 failed: {}",
+                std::io::Error::last_os_error()
+            )));
+        }
+        let epoll_fd = unsafe { OwnedFd::from_raw_fd(epoll) };
+
+        let shutdown = unsafe { libc::eventfd(0, libc::EFD_CLOEXEC) };
+        if shutdown < 0 {
+            return Err(Error::RingBuffer(format!(
+                "eventfd failed: {}",
+                std::io::Error::last_os_error()
+            )));
+        }
+        let shutdown_fd = unsafe { OwnedFd::from_raw_fd(shutdown) };
+
+        for (fd, token) in [(map_fd.as_raw_fd(), 0u64), (shutdown_fd.as_raw_fd(), 1u64)] {
+            let mut event = libc::epoll_event {
+                events: libc::EPOLLIN as u32,
+                u64: token,
+            };
+            let ret = unsafe {
+                libc::epoll_ctl(epoll_fd.as_raw_fd(), libc::EPOLL_CTL_ADD, fd, &mut event)
+            };
+            if ret < 0 {
+                return Err(Error::RingBuffer(format!(
+                    "epoll_ctl failed: {}",
+                    std::io::Error::last_os_error()
+                )));
+            }
+        }
+
+        Ok(Self {
+            map_fd,
+            epoll_fd,
+            shutdown_fd,
+            consumer: consumer as *mut u64,
+            producer: producer as *const u64,
+            data: unsafe { (producer as *const u8).add(page_size) },
+            mask: size - 1,
+            consumer_len,
+            producer_len,
+        })
+    }
+
+    /// Read max_entries (the ring size) via BPF_OBJ_GET_INFO_BY_FD
+    fn ring_size(map_fd: &OwnedFd) -> Result<u64> {
+        // First five u32 fields of struct bpf_map_info:
+        // type, id, key_size, value_size, max_entries
+        let mut info = [0u8; 88];
+
+        #[repr(C)]
+        struct BpfObjGetInfoAttr {
+            bpf_fd: u32,
+            info_len: u32,
+            info: u64,
+        }
+
+        let attr = BpfObjGetInfoAttr {
+            bpf_fd: map_fd.as_raw_fd() as u32,
+            info_len: info.len() as u32,
+            info: info.as_mut_ptr() as u64,
+        };
+
+        let ret = unsafe {
+            libc::syscall(
+                libc::SYS_bpf,
+                15, // BPF_OBJ_GET_INFO_BY_FD
+                &attr as *const _ as *const libc::c_void,
+                std::mem::size_of::<BpfObjGetInfoAttr>(),
+            )
+        };
+        if ret < 0 {
+            return Err(Error::RingBuffer(format!(
+                "BPF_OBJ_GET_INFO_BY_FD failed: {}",
+                std::io::Error::last_os_error()
+            )));
+        }
+
+        let size = u32::from_ne_bytes(info[16..20].try_into().unwrap_or([0u8; 4])) as u64;
+        if size == 0 || !size.is_power_of_two() {
+            return Err(Error::RingBuffer(format!(
+                "unexpected ring size {}",
+                size
+            )));
+        }
+        Ok(size)
+    }
+
+    /// Get a handle that can wake [`poll`](Self::poll) for shutdown
+    pub fn shutdown_handle(&self) -> RingBufShutdown {
+        let dup = unsafe { libc::dup(self.shutdown_fd.as_raw_fd()) };
+        RingBufShutdown {
+            eventfd: (dup >= 0).then(|| unsafe { OwnedFd::from_raw_fd(dup) }),
+        }
+    }
+
+    /// Block until data or shutdown, then drain
+    ///
+    /// Returns `false` when shutdown was signalled.
+    pub fn poll(&mut self, handler: &mut dyn FnMut(&[u8])) -> bool {
+        let mut events = [libc::epoll_event { events: 0, u64: 0 }; 2];
+        let n = unsafe {
+            libc::epoll_wait(
+                self.epoll_fd.as_raw_fd(),
+                events.as_mut_ptr(),
+                events.len() as i32,
+                -1,
+            )
+        };
+
+        if n < 0 {
+            let err = std::io::Error::last_os_error();
+            if err.raw_os_error() == Some(libc::EINTR) {
+                return true;
+            }
+            warn!("epoll_wait failed: {}", err);
+            return false;
+        }
+
+        let mut keep_running = true;
+        for event in events.iter().take(n as usize) {
+            if event.u64 == 1 {
+                keep_running = false;
+            }
+        }
+
+        // Drain regardless: don't strand records behind a shutdown signal
+        self.drain(handler);
+        keep_running
+    }
+
+    /// Drain every completed record currently in the ring
+    ///
+    /// Returns the number of records consumed.
+    pub fn drain(&mut self, handler: &mut dyn FnMut(&[u8])) -> usize {
+        let mut consumed = 0;
+        let mut cons = unsafe { std::ptr::read_volatile(self.consumer) };
+
+        loop {
+            let prod = unsafe {
+                let p = std::ptr::read_volatile(self.producer);
+                std::sync::atomic::fence(Ordering::Acquire);
+                p
+            };
+            if cons >= prod {
+                break;
+            }
+
+            let hdr_ptr = unsafe { self.data.add((cons & self.mask) as usize) } as *const u32;
+            let len = unsafe { std::ptr::read_volatile(hdr_ptr) };
+            // The kernel clears the BUSY bit with a release store after
+            // writing the sample (libbpf pairs this with
+            // smp_load_acquire); without the acquire fence the sample
+            // loads below could be reordered before the committed
+            // length on weakly-ordered hardware and read torn data.
+            std::sync::atomic::fence(Ordering::Acquire);
+            if len & RINGBUF_BUSY_BIT != 0 {
+                // Producer still writing this record
+                break;
+            }
+
+            let sample_len = (len & !(RINGBUF_BUSY_BIT | RINGBUF_DISCARD_BIT)) as u64;
+            if len & RINGBUF_DISCARD_BIT == 0 {
+                let sample = unsafe {
+                    std::slice::from_raw_parts(
+                        self.data.add(((cons + RINGBUF_HDR_SZ) & self.mask) as usize),
+                        sample_len as usize,
+                    )
+                };
+                handler(sample);
+                consumed += 1;
+            }
+
+            cons += RINGBUF_HDR_SZ + sample_len.div_ceil(8) * 8;
+            unsafe {
+                std::sync::atomic::fence(Ordering::Release);
+                std::ptr::write_volatile(self.consumer, cons);
+            }
+        }
+
+        consumed
+    }
+}
+
+impl Drop for HintRingBuffer {
+    fn drop(&mut self) {
+        unsafe {
+            libc::munmap(self.consumer as *mut libc::c_void, self.consumer_len);
+            libc::munmap(self.producer as *mut libc::c_void, self.producer_len);
+        }
+        let _ = &self.map_fd;
+    }
+}
+
+/// Handle for waking a blocked consumer thread at shutdown
+pub struct RingBufShutdown {
+    eventfd: Option<OwnedFd>,
+}
+
+impl RingBufShutdown {
+    /// Signal the consumer thread to exit its poll loop
+    pub fn signal(&self) {
+        if let Some(ref fd) = self.eventfd {
+            let one = 1u64.to_ne_bytes();
+            unsafe {
+                libc::write(fd.as_raw_fd(), one.as_ptr() as *const libc::c_void, 8);
+            }
+        }
+    }
+}
+
+/// Dedicated hint consumer thread
+///
+/// Owns the [`HintRingBuffer`] and blocks in epoll until the kernel
+/// signals data: zero wakeups while idle, batch drain per wakeup. Each
+/// hint updates [`HintConsumer`] state/stats and is routed by
+/// `target_tid` through the [`HintRouter`].
+pub struct HintConsumerThread {
+    handle: Option<std::thread::JoinHandle<()>>,
+    shutdown: RingBufShutdown,
+}
+
+impl HintConsumerThread {
+    /// Spawn the consumer thread
+    pub fn spawn(
+        mut ring: HintRingBuffer,
+        consumer: Arc<HintConsumer>,
+        router: Arc<HintRouter>,
+    ) -> Result<Self> {
+        let shutdown = ring.shutdown_handle();
+        if shutdown.eventfd.is_none() {
+            // Without a working eventfd the thread could never be woken
+            // for shutdown and join() would hang.
+            return Err(Error::RingBuffer(
+                "failed to dup shutdown eventfd".to_string(),
+            ));
+        }
+
+        let handle = std::thread::Builder::new()
+            .name("morpheus-hints".to_string())
+            .spawn(move || {
+                let mut handler = |data: &[u8]| {
+                    consumer.process_hint(data);
+
+                    if data.len() >= std::mem::size_of::<MorpheusHint>() {
+                        let hint = unsafe {
+                            std::ptr::read_unaligned(data.as_ptr() as *const MorpheusHint)
+                        };
+
+                        // Stamp receipt and record the ring buffer +
+                        // wakeup stage. Every ring buffer hint is
+                        // already a 1-in-N sample (user-006), so this
+                        // rate is bounded by construction.
+                        let receive_ns = monotonic_ns();
+                        if hint.emit_ns > 0 && receive_ns > hint.emit_ns {
+                            crate::metrics::metrics().record_hint_stage(
+                                crate::metrics::HintStage::EmitToReceive,
+                                receive_ns - hint.emit_ns,
+                            );
+                        }
+
+                        if !router.route(&hint, receive_ns) {
+                            debug!("hint for unregistered tid {}", hint.target_tid);
+                        }
+                    }
+                };
+
+                while ring.poll(&mut handler) {}
+                debug!("hint consumer thread exiting");
+            })
+            .map_err(|e| Error::RingBuffer(format!("failed to spawn consumer thread: {}", e)))?;
+
+        Ok(Self {
+            handle: Some(handle),
+            shutdown,
+        })
+    }
+
+    /// Signal shutdown and join the thread
+    pub fn shutdown(mut self) {
+        self.shutdown.signal();
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+impl Drop for HintConsumerThread {
+    fn drop(&mut self) {
+        self.shutdown.signal();
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_hint_router_routes_by_tid() {
+        let router = HintRouter::new();
+        let flag_a = router.register(100);
+        let flag_b = router.register(200);
+
+        let hint = |tid: u32| MorpheusHint {
+            seq: 9,
+            reason: 1,
+            target_tid: tid,
+            deadline_ns: 0,
+            emit_ns: 5,
+        };
+
+        assert!(router.route(&hint(100), 7));
+        assert!(flag_a.pending.load(Ordering::Acquire));
+        assert_eq!(flag_a.seq.load(Ordering::Relaxed), 9);
+        assert_eq!(flag_a.emit_ns.load(Ordering::Relaxed), 5);
+        assert_eq!(flag_a.receive_ns.load(Ordering::Relaxed), 7);
+        assert!(
+            !flag_b.pending.load(Ordering::Acquire),
+            "hint must not broadcast"
+        );
+
+        assert!(!router.route(&hint(300), 7), "unregistered tid is reported");
+
+        router.unregister(100);
+        assert!(!router.route(&hint(100), 7));
+    }
+
+    #[test]
+    fn test_sampled_gap_is_not_loss() {
+        let consumer = HintConsumer::with_sample_interval(64);
+        let hint = |seq: u64| {
+            let hint = MorpheusHint {
+                seq,
+                reason: 1,
+                target_tid: 1,
+                deadline_ns: 0,
+                emit_ns: 0,
+            };
+            let bytes = unsafe {
+                std::slice::from_raw_parts(
+                    &hint as *const _ as *const u8,
+                    std::mem::size_of::<MorpheusHint>(),
+                )
+            };
+            bytes.to_vec()
+        };
+
+        consumer.process_hint(&hint(64));
+        consumer.process_hint(&hint(128));
+        assert!(!consumer.is_defensive(), "sampling stride is not loss");
+
+        consumer.process_hint(&hint(1024));
+        assert!(consumer.is_defensive(), "a real gap still trips defense");
+    }
+}
@@ -2,9 +2,11 @@
 //!
 //! The Runtime coordinates workers, SCBs, and executors.
 
-use crate::ringbuf::{DefensiveMode, HintConsumer};
+use crate::error::{Error, Result};
+use crate::executor::ExecutorShared;
+use crate::ringbuf::{DefensiveMode, HintConsumer, HintConsumerThread, HintRingBuffer, HintRouter};
+use crate::sim::{SimConfig, SimKernel};
 use crate::worker::{WorkerConfig, WorkerPool};
-use crossbeam::deque::Injector;
 use parking_lot::RwLock;
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
@@ -22,6 +24,14 @@ pub struct RuntimeConfig {
 
     /// Ring buffer poll timeout
     pub poll_timeout: Duration,
+
+    /// Scheduler-side hint ring buffer sampling interval (1 = unsampled).
+    /// Must match the scheduler's --hint-sample setting.
+    pub hint_sample_interval: u64,
+
+    /// Run against an in-process virtual kernel instead of the BPF
+    /// scheduler (no root, no kernel 6.12 required). See [`crate::sim`].
+    pub simulation: Option<SimConfig>,
 }
 
 impl Default for RuntimeConfig {
@@ -30,6 +40,8 @@ impl Default for RuntimeConfig {
             workers: WorkerConfig::default(),
             defensive_yields: 100,
             poll_timeout: Duration::from_millis(1),
+            hint_sample_interval: 64,
+            simulation: None,
         }
     }
 }
@@ -74,6 +86,24 @@ impl Builder {
         self
     }
 
+    /// Set the scheduler's hint ring buffer sampling interval
+    ///
+    /// Must match the scheduler's `--hint-sample` flag so the consumer's
+    /// drop detection doesn't mistake the sampling stride for loss.
+    pub fn hint_sample_interval(mut self, interval: u64) -> Self {
+        self.config.hint_sample_interval = interval;
+        self
+    }
+
+    /// Run against the in-process simulation backend
+    ///
+    /// Workers get SCB handles over a virtual kernel's table; hints and
+    /// yield requests follow the real memory protocol, unprivileged.
+    pub fn simulation(mut self, config: SimConfig) -> Self {
+        self.config.simulation = Some(config);
+        self
+    }
+
     /// Build the runtime
     ///
     /// Note: This does not connect to the kernel scheduler. Call
@@ -100,9 +130,8 @@ pub struct Runtime {
     /// Worker pool
     workers: RwLock<Option<WorkerPool>>,
 
-    /// Global task injector
-    #[allow(dead_code)]
-    injector: Arc<Injector<async_task::Runnable>>,
+    /// Executor state shared by all workers (injector + parking registry)
+    shared: Arc<ExecutorShared>,
 
     /// Defensive mode controller
     defensive: Arc<DefensiveMode>,
@@ -110,6 +139,15 @@ pub struct Runtime {
     /// Hint consumer
     hints: Arc<HintConsumer>,
 
+    /// Per-worker hint routing table (workers register their TID here)
+    router: Arc<HintRouter>,
+
+    /// Dedicated epoll consumer thread, once connected to the kernel
+    hint_thread: parking_lot::Mutex<Option<HintConsumerThread>>,
+
+    /// Virtual kernel when running in simulation mode
+    sim: RwLock<Option<Arc<SimKernel>>>,
+
     /// Running flag
     running: AtomicBool,
 }
@@ -119,10 +157,15 @@ impl Runtime {
     fn new(config: RuntimeConfig) -> Self {
         Self {
             defensive: Arc::new(DefensiveMode::new(config.defensive_yields)),
+            hints: Arc::new(HintConsumer::with_sample_interval(
+                config.hint_sample_interval,
+            )),
             config,
             workers: RwLock::new(None),
-            injector: Arc::new(Injector::new()),
-            hints: Arc::new(HintConsumer::new()),
+            shared: ExecutorShared::new(),
+            router: Arc::new(HintRouter::new()),
+            hint_thread: parking_lot::Mutex::new(None),
+            sim: RwLock::new(None),
             running: AtomicBool::new(false),
         }
     }
@@ -142,6 +185,96 @@ impl Runtime {
         &self.hints
     }
 
+    /// Get the per-worker hint router
+    pub fn hint_router(&self) -> &Arc<HintRouter> {
+        &self.router
+    }
+
+    /// Connect the runtime to the scheduler's pinned hint ring buffer
+    ///
+    /// Spawns the dedicated epoll consumer thread: zero wakeups while
+    /// the ring is quiet, batch drain per kernel signal, each hint
+    /// routed by target_tid to the owning worker's flag (workers
+    /// started by this runtime register themselves with the router).
+    /// Call once after `start()`; the thread is joined at shutdown.
+    pub fn connect_hints(&self, ringbuf_path: &str) -> Result<()> {
+        let mut slot = self.hint_thread.lock();
+        if slot.is_some() {
+            return Err(Error::RingBuffer(
+                "hint consumer already connected".to_string(),
+            ));
+        }
+
+        let ring = HintRingBuffer::from_pinned_path(ringbuf_path)?;
+        let thread = HintConsumerThread::spawn(ring, self.hints.clone(), self.router.clone())?;
+        *slot = Some(thread);
+        info!("hint consumer connected to {}", ringbuf_path);
+        Ok(())
+    }
+
+    /// Get the shared executor state (for building worker executors)
+    pub fn executor_shared(&self) -> &Arc<ExecutorShared> {
+        &self.shared
+    }
+
+    /// Start the elastic worker pool
+    ///
+    /// Spawns `workers.num_workers` threads - a ceiling, not a burn
+    /// rate: idle workers park (PARKED lifecycle state) and cost no CPU
+    /// until injected work or kernel pressure signals unpark them.
+    pub fn start(&self) {
+        // Simulation mode: stand up the virtual kernel and hand each
+        // worker an SCB over its table.
+        let mut scbs = Vec::new();
+        if let Some(sim_config) = &self.config.simulation {
+            let mut sim_config = sim_config.clone();
+            sim_config.num_workers = sim_config.num_workers.max(self.config.workers.num_workers);
+            let sim = SimKernel::start(sim_config);
+            for worker_id in 0..self.config.workers.num_workers {
+                if let Ok(scb) = sim.scb_handle(worker_id as u32, self.config.workers.escapable) {
+                    scbs.push(scb);
+                }
+            }
+            *self.sim.write() = Some(sim);
+        }
+
+        let mut pool = WorkerPool::new(self.config.workers.clone());
+        pool.start(&self.shared, &self.defensive, &scbs, Some(&self.router));
+
+        // Bind worker tids so simulated hints carry real targets
+        if let Some(sim) = self.sim.read().as_ref() {
+            for worker in pool.workers() {
+                sim.bind_worker(worker.id, worker.tid);
+            }
+        }
+
+        *self.workers.write() = Some(pool);
+        self.running.store(true, Ordering::Release);
+        info!(
+            "Morpheus runtime started ({} workers, elastic{})",
+            self.config.workers.num_workers,
+            if self.config.simulation.is_some() {
+                ", simulated kernel"
+            } else {
+                ""
+            }
+        );
+    }
+
+    /// Get the virtual kernel when running in simulation mode
+    pub fn sim_kernel(&self) -> Option<Arc<SimKernel>> {
+        self.sim.read().clone()
+    }
+
+    /// Spawn a task onto the runtime's workers
+    pub fn spawn<F>(&self, future: F) -> async_task::Task<F::Output>
+    where
+        F: std::future::Future + Send + 'static,
+        F::Output: Send + 'static,
+    {
+        self.shared.spawn(future)
+    }
+
     /// Get the defensive mode controller
     pub fn defensive(&self) -> &Arc<DefensiveMode> {
         &self.defensive
@@ -150,11 +283,20 @@ impl Runtime {
     /// Shutdown the runtime
     pub fn shutdown(&self) {
         self.running.store(false, Ordering::Release);
+        self.shared.shutdown();
 
         if let Some(ref mut pool) = *self.workers.write() {
             pool.shutdown();
         }
 
+        if let Some(thread) = self.hint_thread.lock().take() {
+            thread.shutdown();
+        }
+
+        if let Some(sim) = self.sim.write().take() {
+            sim.shutdown();
+        }
+
         info!("Morpheus runtime shutdown complete");
     }
 
@@ -199,6 +341,27 @@ pub fn shutdown() {
 mod tests {
     use super::*;
 
+    #[test]
+    fn test_start_spawn_shutdown() {
+        let runtime = Builder::new().num_workers(2).build();
+        runtime.start();
+        assert!(runtime.is_running());
+
+        let (tx, rx) = std::sync::mpsc::channel();
+        runtime
+            .spawn(async move {
+                tx.send(99).unwrap();
+            })
+            .detach();
+        assert_eq!(
+            rx.recv_timeout(std::time::Duration::from_secs(5)).unwrap(),
+            99
+        );
+
+        runtime.shutdown();
+        assert!(!runtime.is_running());
+    }
+
     #[test]
     fn test_builder() {
         let runtime = Builder::new()
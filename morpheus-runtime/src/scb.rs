@@ -4,7 +4,7 @@
 //! This module provides safe Rust wrappers for SCB access.
 
 use crate::error::{Error, Result};
-use morpheus_common::{config, MorpheusScb};
+use morpheus_common::{config, HintReason, MorpheusScb};
 use std::fs::File;
 use std::os::fd::{AsRawFd, BorrowedFd};
 use std::os::unix::io::FromRawFd;
@@ -18,8 +18,16 @@ use std::sync::atomic::Ordering;
 pub struct ScbHandle {
     ptr: NonNull<MorpheusScb>,
     worker_id: u32,
-    // Keep the mmap alive
-    _mmap: memmap2::MmapMut,
+    // Keep the backing memory alive
+    _backing: Backing,
+}
+
+/// What keeps the SCB memory alive
+enum Backing {
+    /// Kernel mode: a mapping of the BPF scb_map
+    Mmap(#[allow(dead_code)] memmap2::MmapMut),
+    /// Simulation mode: a slot in an in-process SCB table
+    Shared(#[allow(dead_code)] std::sync::Arc<[MorpheusScb]>),
 }
 
 // SCB access is thread-safe through atomics
@@ -67,8 +75,21 @@ impl ScbHandle {
         let ptr = NonNull::new(mmap.as_ptr() as *mut MorpheusScb)
             .ok_or_else(|| Error::Mmap(std::io::Error::other("mmap returned null")))?;
 
-        // Initialize the SCB
+        // Negotiate the layout version: the scheduler stamps its slots
+        // in morpheus_init; a nonzero mismatch means it speaks a
+        // different layout (e.g. a v1 scheduler) and we must not attach.
         let scb = &*ptr.as_ptr();
+        let version = scb.version.load(Ordering::Acquire);
+        if version != 0 && version != config::SCB_VERSION {
+            return Err(Error::NotSupported(format!(
+                "SCB layout version mismatch: scheduler has v{}, runtime speaks v{}",
+                version,
+                config::SCB_VERSION
+            )));
+        }
+        scb.version.store(config::SCB_VERSION, Ordering::Release);
+
+        // Initialize the SCB
         scb.preempt_seq.store(0, Ordering::Release);
         scb.budget_remaining_ns
             .store(config::DEFAULT_SLICE_NS, Ordering::Release);
@@ -82,7 +103,42 @@ impl ScbHandle {
         Ok(Self {
             ptr,
             worker_id,
-            _mmap: mmap,
+            _backing: Backing::Mmap(mmap),
+        })
+    }
+
+    /// Create an SCB handle over a slot of an in-process SCB table
+    ///
+    /// Used by the simulation backend: the table plays the role of the
+    /// kernel's scb_map and the handle keeps it alive. Initializes the
+    /// slot exactly like the kernel-backed constructor.
+    pub(crate) fn from_shared(
+        table: std::sync::Arc<[MorpheusScb]>,
+        worker_id: u32,
+        escapable: bool,
+    ) -> Result<Self> {
+        let slot = table
+            .get(worker_id as usize)
+            .ok_or(Error::InvalidWorker(worker_id))?;
+
+        let ptr = NonNull::from(slot);
+
+        let scb = unsafe { &*ptr.as_ptr() };
+        scb.version.store(config::SCB_VERSION, Ordering::Release);
+        scb.preempt_seq.store(0, Ordering::Release);
+        scb.budget_remaining_ns
+            .store(config::DEFAULT_SLICE_NS, Ordering::Release);
+        scb.kernel_pressure_level.store(0, Ordering::Release);
+        scb.is_in_critical_section.store(0, Ordering::Release);
+        scb.escapable
+            .store(if escapable { 1 } else { 0 }, Ordering::Release);
+        scb.last_ack_seq.store(0, Ordering::Release);
+        scb.runtime_priority.store(500, Ordering::Release);
+
+        Ok(Self {
+            ptr,
+            worker_id,
+            _backing: Backing::Shared(table),
         })
     }
 
@@ -108,6 +164,26 @@ impl ScbHandle {
         preempt > acked
     }
 
+    /// Get the pending coalesced hint, if a yield is requested
+    ///
+    /// The kernel writes reason and deadline into the SCB before bumping
+    /// `preempt_seq`, so once `yield_requested()` is true these fields
+    /// describe the outstanding request. Unlike the ring buffer this
+    /// path cannot overflow or drop hints.
+    #[inline]
+    pub fn pending_hint(&self) -> Option<(HintReason, u64)> {
+        if !self.yield_requested() {
+            return None;
+        }
+
+        let scb = self.scb();
+        let reason = scb.pending_hint_reason.load(Ordering::Relaxed);
+        let deadline_ns = scb.pending_hint_deadline_ns.load(Ordering::Relaxed);
+        HintReason::try_from(reason)
+            .ok()
+            .map(|reason| (reason, deadline_ns))
+    }
+
     /// Acknowledge a yield request
     ///
     /// This should be called after yielding to tell the kernel we responded.
@@ -164,7 +240,130 @@ impl ScbHandle {
             .runtime_priority
             .store(priority.min(1000), Ordering::Release);
     }
+
+    /// Post an EDF deadline reservation for this worker
+    ///
+    /// While the reservation is held (RAII guard), the scheduler
+    /// dispatches this worker earliest-deadline-first ahead of every
+    /// ordinary shard, and pushes MORPHEUS_HINT_DEADLINE at competing
+    /// workers as the deadline approaches.
+    ///
+    /// Admission control rejects reservations the current load can't
+    /// honor: when kernel pressure exceeds
+    /// [`RESERVATION_PRESSURE_LIMIT`] or the process already holds as
+    /// many active reservations as the machine has CPUs, the request
+    /// fails with [`Error::ReservationRejected`] instead of silently
+    /// degrading every other reservation's guarantee.
+    ///
+    /// `deadline_ns` is absolute CLOCK_MONOTONIC nanoseconds; use
+    /// [`reserve_for`](Self::reserve_for) for a relative deadline.
+    pub fn reserve_deadline(&self, deadline_ns: u64) -> Result<ReservationGuard<'_>> {
+        let pressure = self.pressure_level();
+        if pressure > RESERVATION_PRESSURE_LIMIT {
+            return Err(Error::ReservationRejected(format!(
+                "kernel pressure {} exceeds limit {}",
+                pressure, RESERVATION_PRESSURE_LIMIT
+            )));
+        }
+
+        let limit = std::thread::available_parallelism()
+            .map(|n| n.get() as u32)
+            .unwrap_or(1);
+        let active = ACTIVE_RESERVATIONS.fetch_add(1, Ordering::AcqRel);
+        if active >= limit {
+            ACTIVE_RESERVATIONS.fetch_sub(1, Ordering::AcqRel);
+            return Err(Error::ReservationRejected(format!(
+                "{} reservations already active (limit {})",
+                active, limit
+            )));
+        }
+
+        self.scb()
+            .reservation_token
+            .store(deadline_ns.max(1), Ordering::Release);
+        Ok(ReservationGuard { scb: self })
+    }
+
+    /// Post a reservation expiring `duration_ns` from now
+    pub fn reserve_for(&self, duration_ns: u64) -> Result<ReservationGuard<'_>> {
+        self.reserve_deadline(crate::ringbuf::monotonic_ns() + duration_ns)
+    }
+
+    /// Set or clear the NUMA node affinity hint
+    ///
+    /// The scheduler avoids migrating this worker off the preferred node
+    /// unless the node's runqueue shard is backed up. Advisory only.
+    #[inline]
+    pub fn set_preferred_node(&self, node: Option<u32>) {
+        let encoded = node.map(|n| n + 1).unwrap_or(0);
+        self.scb().preferred_node.store(encoded, Ordering::Release);
+    }
+}
+
+/// Kernel pressure level above which new reservations are rejected
+pub const RESERVATION_PRESSURE_LIMIT: u32 = 75;
+
+/// Active reservations held by this process (admission accounting)
+static ACTIVE_RESERVATIONS: std::sync::atomic::AtomicU32 = std::sync::atomic::AtomicU32::new(0);
+
+/// RAII guard for an active deadline reservation
+///
+/// Dropping the guard clears the SCB token (the scheduler falls back to
+/// ordinary shard dispatch on the next enqueue) and releases the
+/// admission slot.
+pub struct ReservationGuard<'a> {
+    scb: &'a ScbHandle,
+}
+
+impl Drop for ReservationGuard<'_> {
+    fn drop(&mut self) {
+        self.scb
+            .scb()
+            .reservation_token
+            .store(0, Ordering::Release);
+        ACTIVE_RESERVATIONS.fetch_sub(1, Ordering::AcqRel);
+    }
 }
 
 // Note: For creating SCB handles from libbpf-rs maps, use ScbHandle::new()
 // directly with the map's file descriptor.
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::sim::{SimConfig, SimKernel};
+
+    #[test]
+    fn test_reservation_admission_and_token_lifecycle() {
+        let sim = SimKernel::start(SimConfig::default());
+        let scb = sim.scb_handle(0, true).unwrap();
+
+        // Accepted: token posted, cleared on drop
+        {
+            let _guard = scb.reserve_deadline(123_456_789).expect("admitted");
+            assert_eq!(
+                scb.scb().reservation_token.load(Ordering::Acquire),
+                123_456_789
+            );
+        }
+        assert_eq!(scb.scb().reservation_token.load(Ordering::Acquire), 0);
+
+        // Rejected under pressure
+        scb.scb()
+            .kernel_pressure_level
+            .store(90, Ordering::Release);
+        assert!(matches!(
+            scb.reserve_deadline(1),
+            Err(Error::ReservationRejected(_))
+        ));
+        scb.scb().kernel_pressure_level.store(0, Ordering::Release);
+
+        // Relative helper posts a future deadline
+        let before = crate::ringbuf::monotonic_ns();
+        let guard = scb.reserve_for(1_000_000).expect("admitted");
+        assert!(scb.scb().reservation_token.load(Ordering::Acquire) >= before);
+        drop(guard);
+
+        sim.shutdown();
+    }
+}
@@ -3,11 +3,15 @@
 //! Each worker thread owns one SCB and runs a local async executor.
 //! Workers are registered with the kernel via the worker_tid_map.
 
+use crate::executor::{ExecutorShared, LocalExecutor};
+use crate::ringbuf::{DefensiveMode, HintRouter};
 use crate::scb::ScbHandle;
+use morpheus_common::MorpheusScb;
 use parking_lot::Mutex;
-use std::cell::RefCell;
+use std::cell::{Cell, RefCell};
 use std::num::NonZeroUsize;
-use std::sync::Arc;
+use std::sync::atomic::Ordering;
+use std::sync::{mpsc, Arc};
 use std::thread::JoinHandle;
 
 thread_local! {
@@ -16,6 +20,53 @@ thread_local! {
 
     /// The worker ID for the current thread
     static WORKER_ID: RefCell<Option<u32>> = const { RefCell::new(None) };
+
+    /// Raw pointer to the current worker's SCB - the checkpoint fast path.
+    ///
+    /// Kept alive by the Arc in CURRENT_SCB; both are installed and
+    /// cleared together. Null when this thread is not a worker.
+    static FAST_SCB: Cell<*const MorpheusScb> = const { Cell::new(std::ptr::null()) };
+
+    /// Shadow of last_ack_seq, so the checkpoint fast path is one
+    /// relaxed load and a compare against thread-local state.
+    static ACK_SHADOW: Cell<u64> = const { Cell::new(0) };
+}
+
+/// Checkpoint fast path: is a kernel yield request pending?
+///
+/// The no-yield case is a single relaxed load of `preempt_seq` compared
+/// against a TLS shadow of `last_ack_seq` - no Arc clone, no RefCell
+/// borrow, no shared-line store. The shadow is re-synced from the SCB in
+/// the cold path, which runs once per ack or pending request.
+#[inline]
+pub fn fast_yield_check() -> bool {
+    FAST_SCB.with(|ptr| {
+        let scb = ptr.get();
+        if scb.is_null() {
+            return false;
+        }
+
+        // SAFETY: non-null means CURRENT_SCB holds the owning Arc for
+        // this thread, keeping the mapping alive.
+        let scb = unsafe { &*scb };
+        let seq = scb.preempt_seq.load(Ordering::Relaxed);
+        if seq == ACK_SHADOW.with(Cell::get) {
+            return false;
+        }
+
+        fast_yield_check_slow(scb, seq)
+    })
+}
+
+/// Cold path: the sequence moved past the shadow
+///
+/// Either a yield request is pending, or an ack happened and the shadow
+/// is stale - re-sync it from the authoritative field.
+#[cold]
+fn fast_yield_check_slow(scb: &MorpheusScb, seq: u64) -> bool {
+    let acked = scb.last_ack_seq.load(Ordering::Acquire);
+    ACK_SHADOW.with(|shadow| shadow.set(acked));
+    seq > acked
 }
 
 /// Get the current worker's SCB handle, if running on a worker thread
@@ -39,8 +90,13 @@ pub fn current_worker_id() -> Option<u32> {
 }
 
 /// Set the current thread's SCB (called during worker initialization)
-#[allow(dead_code)]
 pub fn set_current_scb(scb: Arc<ScbHandle>, worker_id: u32) {
+    FAST_SCB.with(|ptr| ptr.set(scb.scb() as *const MorpheusScb));
+    ACK_SHADOW.with(|shadow| {
+        shadow.set(
+            scb.scb().last_ack_seq.load(Ordering::Acquire),
+        )
+    });
     CURRENT_SCB.with(|current| {
         *current.borrow_mut() = Some(scb);
     });
@@ -49,6 +105,21 @@ pub fn set_current_scb(scb: Arc<ScbHandle>, worker_id: u32) {
     });
 }
 
+/// Clear the current thread's SCB (called during worker teardown)
+///
+/// Must be called before the owning ScbHandle is dropped; it clears the
+/// fast-path raw pointer along with the handle.
+pub fn clear_current_scb() {
+    FAST_SCB.with(|ptr| ptr.set(std::ptr::null()));
+    ACK_SHADOW.with(|shadow| shadow.set(0));
+    CURRENT_SCB.with(|current| {
+        *current.borrow_mut() = None;
+    });
+    WORKER_ID.with(|id| {
+        *id.borrow_mut() = None;
+    });
+}
+
 /// Worker thread state
 pub struct Worker {
     /// Worker ID (index into SCB map)
@@ -57,8 +128,8 @@ pub struct Worker {
     /// OS thread ID (for kernel registration)
     pub tid: u32,
 
-    /// SCB handle
-    pub scb: Arc<ScbHandle>,
+    /// SCB handle (None when running without a kernel scheduler)
+    pub scb: Option<Arc<ScbHandle>>,
 
     /// Thread join handle
     pub handle: Option<JoinHandle<()>>,
@@ -116,6 +187,117 @@ impl WorkerPool {
         &self.config
     }
 
+    /// Get the workers (available after start)
+    pub fn workers(&self) -> &[Worker] {
+        &self.workers
+    }
+
+    /// Spawn the worker threads
+    ///
+    /// Each thread builds its own LocalExecutor (executors are !Send),
+    /// exchanges stealers with its siblings through a rendezvous, then
+    /// enters the run loop. Workers size themselves from load: idle ones
+    /// park (transitioning their SCB to PARKED when one is installed)
+    /// and are unparked by injected work, so num_workers is a ceiling,
+    /// not a fixed burn rate.
+    pub fn start(
+        &mut self,
+        shared: &Arc<ExecutorShared>,
+        defensive: &Arc<DefensiveMode>,
+        scbs: &[Arc<ScbHandle>],
+        router: Option<&Arc<HintRouter>>,
+    ) {
+        let count = self.config.num_workers;
+        let (stealer_tx, stealer_rx) = mpsc::channel();
+        let mut wires = Vec::with_capacity(count);
+
+        for id in 0..count {
+            let (wire_tx, wire_rx) = mpsc::channel();
+            wires.push(wire_tx);
+
+            let shared = shared.clone();
+            let defensive = defensive.clone();
+            let stealer_tx = stealer_tx.clone();
+            let scb = scbs.get(id).cloned();
+            let router = router.cloned();
+            let name = format!("{}-{}", self.config.name_prefix, id);
+
+            let handle = std::thread::Builder::new()
+                .name(name)
+                .spawn(move || {
+                    let tid = get_tid();
+
+                    if let Some(ref scb) = scb {
+                        set_current_scb(scb.clone(), id as u32);
+                        scb.scb().worker_state.store(
+                            morpheus_common::WorkerState::Running as u32,
+                            Ordering::Release,
+                        );
+                    }
+
+                    // Register with the hint router so the consumer
+                    // thread can route this worker's hints to us.
+                    if let Some(ref router) = router {
+                        crate::ringbuf::install_hint_flag(router.register(tid));
+                    }
+
+                    let mut executor = LocalExecutor::new(shared, Vec::new(), defensive);
+                    let _ = stealer_tx.send((id, tid, executor.stealer()));
+                    if let Ok(stealers) = wire_rx.recv() {
+                        for stealer in stealers {
+                            executor.add_stealer(stealer);
+                        }
+                    }
+                    executor.run();
+
+                    if let Some(ref router) = router {
+                        crate::ringbuf::clear_hint_flag();
+                        router.unregister(tid);
+                    }
+                    if let Some(ref scb) = scb {
+                        scb.scb().worker_state.store(
+                            morpheus_common::WorkerState::Quiescing as u32,
+                            Ordering::Release,
+                        );
+                        clear_current_scb();
+                    }
+                })
+                .expect("failed to spawn worker thread");
+
+            self.workers.push(Worker {
+                id: id as u32,
+                tid: 0,
+                scb: scbs.get(id).cloned(),
+                handle: Some(handle),
+            });
+        }
+
+        // Rendezvous: collect every worker's stealer, then hand each
+        // worker its siblings' set.
+        let mut stealers = Vec::with_capacity(count);
+        for _ in 0..count {
+            if let Ok(entry) = stealer_rx.recv() {
+                stealers.push(entry);
+            }
+        }
+        stealers.sort_by_key(|(id, _, _)| *id);
+
+        for (id, tid, _) in &stealers {
+            if let Some(worker) = self.workers.get_mut(*id) {
+                worker.tid = *tid;
+            }
+        }
+
+        for (id, wire_tx) in wires.iter().enumerate() {
+            let siblings: Vec<_> = stealers
+                .iter()
+                .filter(|(other, _, _)| *other != id)
+                .map(|(_, _, stealer)| stealer.clone())
+                .collect();
+            let _ = wire_tx.send(siblings);
+        }
+    }
+
     /// Shutdown all workers
     pub fn shutdown(&mut self) {
         *self.shutdown.lock() = true;
@@ -35,6 +35,10 @@ pub use morpheus_runtime::{
     checkpoint_sync, critical_section, BpfMaps, CriticalGuard, Error, Result, ScbHandle,
 };
 
+use std::future::Future;
+use std::sync::atomic::{AtomicU32, Ordering};
+use std::sync::{Arc, Mutex};
+
 pub use morpheus_common::{
     EscalationPolicy, GlobalPressure, HintReason, MorpheusHint, MorpheusScb, RuntimeMode,
     SchedulerMode, WorkerState, YieldReason,
@@ -110,10 +114,107 @@ where
     .await
 }
 
+/// Poll allowance when a full kernel slice remains (matches Tokio's own
+/// cooperative budget of 128 operations)
+const COOP_BASE_POLLS: u32 = 128;
+
+/// Couple a task's cooperative yielding to the kernel's remaining slice.
+///
+/// Tokio's coop budget and the kernel's `budget_remaining_ns` don't talk:
+/// a task can exhaust its kernel slice while Tokio still thinks it has
+/// plenty of coop budget, and the yield then arrives a full grace period
+/// late via the hint/escalation path. This wrapper re-derives the
+/// effective poll allowance from the SCB on every poll:
+///
+/// - a full slice allows `COOP_BASE_POLLS` polls between yields
+/// - the allowance shrinks linearly as `budget_remaining_ns` runs down,
+///   and is halved/quartered under elevated `kernel_pressure_level`
+/// - a pending kernel yield request is honored (and acknowledged)
+///   immediately
+///
+/// so slice exhaustion becomes an ordinary cooperative yield instead of
+/// an escalation-path event. Off-worker (no SCB) it is a transparent
+/// passthrough.
+pub fn with_kernel_budget<F: Future>(future: F) -> BudgetCoupled<F> {
+    BudgetCoupled {
+        inner: future,
+        polls_since_yield: 0,
+    }
+}
+
+/// Future wrapper created by [`with_kernel_budget`]
+pub struct BudgetCoupled<F> {
+    inner: F,
+    polls_since_yield: u32,
+}
+
+impl<F: Future> Future for BudgetCoupled<F> {
+    type Output = F::Output;
+
+    fn poll(self: std::pin::Pin<&mut Self>, cx: &mut std::task::Context<'_>) -> std::task::Poll<F::Output> {
+        // SAFETY: inner is structurally pinned; polls_since_yield is not.
+        let this = unsafe { self.get_unchecked_mut() };
+
+        if let Some(scb) = morpheus_runtime::worker::try_current_scb() {
+            // A pending kernel request always wins
+            if scb.yield_requested() {
+                morpheus_runtime::events::record_checkpoint_yield();
+                scb.acknowledge();
+                this.polls_since_yield = 0;
+                cx.waker().wake_by_ref();
+                return std::task::Poll::Pending;
+            }
+
+            // Strictly-greater comparison guarantees forward progress:
+            // even with the allowance clamped to 1, the inner future is
+            // polled at least once between injected yields.
+            this.polls_since_yield += 1;
+            if this.polls_since_yield > poll_allowance(&scb) {
+                this.polls_since_yield = 0;
+                cx.waker().wake_by_ref();
+                return std::task::Poll::Pending;
+            }
+        }
+
+        unsafe { std::pin::Pin::new_unchecked(&mut this.inner) }.poll(cx)
+    }
+}
+
+/// Effective polls-between-yields derived from the kernel slice state
+fn poll_allowance(scb: &ScbHandle) -> u32 {
+    let budget_ns = scb.budget_remaining_ns();
+    let slice_ns = morpheus_common::config::DEFAULT_SLICE_NS;
+
+    // Linear in remaining slice, clamped to [1, COOP_BASE_POLLS]
+    let mut allowance = ((COOP_BASE_POLLS as u64 * budget_ns.min(slice_ns)) / slice_ns) as u32;
+
+    // Pressure shrinks the allowance further
+    let pressure = scb.pressure_level();
+    if pressure > 75 {
+        allowance /= 4;
+    } else if pressure > 50 {
+        allowance /= 2;
+    }
+
+    allowance.max(1)
+}
+
 /// Builder for configuring Morpheus with Tokio.
+///
+/// [`attach`](Self::attach) installs runtime hooks on a
+/// `tokio::runtime::Builder` so every Tokio worker thread is
+/// automatically registered with the kernel scheduler on start (SCB
+/// created and installed, TID written to the worker map), transitions
+/// through the lifecycle machine on park/unpark, and deregisters on
+/// stop. Without this, Tokio threads run unregistered and invisible to
+/// the scheduler - hints and budgets only cover part of the compute.
+///
+/// When the scheduler's pinned maps are absent (no kernel side loaded),
+/// the hooks degrade to no-ops so the same binary runs everywhere.
 pub struct MorpheusTokioBuilder {
     escapable: bool,
     check_interval_ms: u64,
+    pin_dir: String,
 }
 
 impl Default for MorpheusTokioBuilder {
@@ -121,6 +222,7 @@ impl Default for MorpheusTokioBuilder {
         Self {
             escapable: true, // Rust default
             check_interval_ms: 1,
+            pin_dir: "/sys/fs/bpf/morpheus".to_string(),
         }
     }
 }
@@ -147,6 +249,14 @@ impl MorpheusTokioBuilder {
         self
     }
 
+    /// Set the directory where the scheduler pinned its maps.
+    ///
+    /// Default: `/sys/fs/bpf/morpheus` (the loader's `--pin-maps` path).
+    pub fn pin_dir(mut self, dir: impl Into<String>) -> Self {
+        self.pin_dir = dir.into();
+        self
+    }
+
     /// Get the escapable setting.
     pub fn is_escapable(&self) -> bool {
         self.escapable
@@ -156,6 +266,140 @@ impl MorpheusTokioBuilder {
     pub fn get_check_interval(&self) -> std::time::Duration {
         std::time::Duration::from_millis(self.check_interval_ms)
     }
+
+    /// Install Morpheus worker hooks on a Tokio runtime builder.
+    ///
+    /// Every worker thread the runtime spawns is registered with the
+    /// kernel on start and deregistered on stop; park/unpark transition
+    /// the SCB lifecycle state so parked Tokio workers receive no hints.
+    /// Worker ids are recycled as threads stop, so short-lived runtimes
+    /// don't exhaust the SCB table.
+    pub fn attach<'a>(
+        self,
+        builder: &'a mut tokio::runtime::Builder,
+    ) -> &'a mut tokio::runtime::Builder {
+        let state = Arc::new(TokioWorkerState::new(&self.pin_dir, self.escapable));
+
+        let start_state = state.clone();
+        let stop_state = state.clone();
+
+        builder
+            .on_thread_start(move || start_state.register_current_thread())
+            .on_thread_stop(move || stop_state.deregister_current_thread())
+            .on_thread_park(|| set_worker_parked(true))
+            .on_thread_unpark(|| set_worker_parked(false))
+    }
+}
+
+/// Process-global worker id allocator
+///
+/// Multiple Tokio runtimes can be attached in one process; ids must be
+/// unique across all of them or their SCB slots would collide.
+static NEXT_WORKER_ID: AtomicU32 = AtomicU32::new(0);
+static FREE_WORKER_IDS: Mutex<Vec<u32>> = Mutex::new(Vec::new());
+
+fn allocate_worker_id() -> u32 {
+    if let Some(id) = FREE_WORKER_IDS.lock().unwrap().pop() {
+        return id;
+    }
+    NEXT_WORKER_ID.fetch_add(1, Ordering::Relaxed)
+}
+
+fn release_worker_id(id: u32) {
+    FREE_WORKER_IDS.lock().unwrap().push(id);
+}
+
+/// Shared registration state behind the Tokio hooks
+struct TokioWorkerState {
+    /// Kernel maps; None when no scheduler is loaded (hooks degrade)
+    maps: Option<BpfMaps>,
+    escapable: bool,
+}
+
+impl TokioWorkerState {
+    fn new(pin_dir: &str, escapable: bool) -> Self {
+        let maps = BpfMaps::from_pinned_paths(
+            &format!("{}/worker_tid_map", pin_dir),
+            &format!("{}/scb_map", pin_dir),
+        )
+        // Best-effort: a pre-prefilter scheduler pins no reg_gen_map,
+        // and that must not disable auto-registration entirely.
+        .map(|maps| maps.with_reg_gen_map(&format!("{}/reg_gen_map", pin_dir)))
+        .map_err(|e| {
+            tracing::info!(
+                "Morpheus scheduler maps not available ({}); Tokio workers run unregistered",
+                e
+            );
+            e
+        })
+        .ok();
+
+        Self { maps, escapable }
+    }
+
+    fn register_current_thread(&self) {
+        let Some(maps) = &self.maps else { return };
+
+        let worker_id = allocate_worker_id();
+        let tid = morpheus_runtime::worker::get_tid();
+
+        let scb = match unsafe { ScbHandle::new(maps.scb_map_fd(), worker_id, self.escapable) } {
+            Ok(scb) => Arc::new(scb),
+            Err(e) => {
+                tracing::warn!("failed to map SCB for tokio worker {}: {}", worker_id, e);
+                release_worker_id(worker_id);
+                return;
+            }
+        };
+
+        if let Err(e) = maps.register_worker(tid, worker_id) {
+            tracing::warn!("failed to register tokio worker tid={}: {}", tid, e);
+            release_worker_id(worker_id);
+            return;
+        }
+
+        scb.scb()
+            .worker_state
+            .store(WorkerState::Running as u32, Ordering::Release);
+        morpheus_runtime::worker::set_current_scb(scb, worker_id);
+
+        tracing::debug!("tokio worker tid={} registered as morpheus worker {}", tid, worker_id);
+    }
+
+    fn deregister_current_thread(&self) {
+        let Some(maps) = &self.maps else { return };
+
+        if let Some(scb) = morpheus_runtime::worker::try_current_scb() {
+            let worker_id = scb.worker_id();
+            scb.scb()
+                .worker_state
+                .store(WorkerState::Dead as u32, Ordering::Release);
+            morpheus_runtime::worker::clear_current_scb();
+
+            let tid = morpheus_runtime::worker::get_tid();
+            let _ = maps.unregister_worker(tid);
+            release_worker_id(worker_id);
+
+            tracing::debug!("tokio worker tid={} deregistered", tid);
+        }
+    }
+}
+
+/// Flip the current worker's lifecycle state between RUNNING and PARKED
+fn set_worker_parked(parked: bool) {
+    if let Some(scb) = morpheus_runtime::worker::try_current_scb() {
+        let (from, to) = if parked {
+            (WorkerState::Running, WorkerState::Parked)
+        } else {
+            (WorkerState::Parked, WorkerState::Running)
+        };
+        let _ = scb.scb().worker_state.compare_exchange(
+            from as u32,
+            to as u32,
+            Ordering::Release,
+            Ordering::Relaxed,
+        );
+    }
 }
 
 #[cfg(test)]
@@ -178,9 +422,83 @@ mod tests {
         assert_eq!(builder.get_check_interval().as_millis(), 10);
     }
 
+    #[test]
+    fn test_attach_without_scheduler_degrades_cleanly() {
+        // No pinned maps in this environment: the hooks must no-op and
+        // the runtime must work normally.
+        let mut builder = tokio::runtime::Builder::new_multi_thread();
+        builder.worker_threads(2).enable_time();
+        MorpheusTokioBuilder::new()
+            .pin_dir("/nonexistent/morpheus")
+            .attach(&mut builder);
+
+        let runtime = builder.build().expect("runtime builds with hooks");
+        let result = runtime.block_on(async {
+            tokio::task::yield_now().await;
+            checkpoint_sync()
+        });
+        assert!(!result, "no scheduler, no yield requests");
+        drop(runtime); // on_thread_stop hooks must not panic
+    }
+
     #[tokio::test]
     async fn test_checkpoint_sync() {
         // Should return false when no kernel connected
         assert!(!checkpoint_sync());
     }
+
+    #[tokio::test]
+    async fn test_budget_coupled_passthrough_without_scb() {
+        // Off-worker: the wrapper must be transparent
+        let value = with_kernel_budget(async { 42 }).await;
+        assert_eq!(value, 42);
+    }
+
+    #[test]
+    fn test_budget_coupled_yields_early_when_slice_exhausted() {
+        use morpheus_runtime::sim::{SimConfig, SimKernel};
+        use std::sync::atomic::Ordering;
+
+        // Attach this thread to a virtual kernel SCB with no budget left
+        let sim = SimKernel::start(SimConfig::default());
+        let scb = sim.scb_handle(0, true).unwrap();
+        scb.scb().budget_remaining_ns.store(0, Ordering::Release);
+        morpheus_runtime::worker::set_current_scb(scb.clone(), 0);
+
+        let runtime = tokio::runtime::Builder::new_current_thread()
+            .build()
+            .unwrap();
+
+        // Count how many polls the inner future sees before completion:
+        // with allowance clamped to 1, every other poll must be a
+        // cooperative yield injected by the wrapper.
+        let mut inner_polls = 0u32;
+        runtime.block_on(with_kernel_budget(std::future::poll_fn(|cx| {
+            inner_polls += 1;
+            if inner_polls < 3 {
+                cx.waker().wake_by_ref();
+                return std::task::Poll::Pending;
+            }
+            std::task::Poll::<()>::Ready(())
+        })));
+        assert_eq!(inner_polls, 3);
+
+        // Restore a full slice: allowance goes back to COOP_BASE_POLLS
+        scb.scb()
+            .budget_remaining_ns
+            .store(morpheus_common::config::DEFAULT_SLICE_NS, Ordering::Release);
+        assert_eq!(super::poll_allowance(&scb), super::COOP_BASE_POLLS);
+        scb.scb().budget_remaining_ns.store(0, Ordering::Release);
+        assert_eq!(super::poll_allowance(&scb), 1);
+
+        // Pressure shrinks the allowance too
+        scb.scb()
+            .budget_remaining_ns
+            .store(morpheus_common::config::DEFAULT_SLICE_NS, Ordering::Release);
+        scb.scb().kernel_pressure_level.store(80, Ordering::Release);
+        assert_eq!(super::poll_allowance(&scb), super::COOP_BASE_POLLS / 4);
+
+        morpheus_runtime::worker::clear_current_scb();
+        sim.shutdown();
+    }
 }
@@ -199,6 +199,16 @@ struct user_exit_info {
 } while (0)
 #endif
 
+/* ============================================================================
+ * bpf_timer constants
+ *
+ * CLOCK_MONOTONIC is a uapi constant that vmlinux.h does not always carry.
+ * ============================================================================ */
+
+#ifndef CLOCK_MONOTONIC
+#define CLOCK_MONOTONIC 1
+#endif
+
 /* ============================================================================
  * Time comparison helpers
  * ============================================================================ */
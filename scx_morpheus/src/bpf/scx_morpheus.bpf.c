@@ -49,6 +49,13 @@ const volatile u32 max_workers = MORPHEUS_MAX_WORKERS;
 const volatile bool debug_mode = false;
 const volatile u32 scheduler_mode = MORPHEUS_MODE_OBSERVER_ONLY;
 
+/*
+ * Ring buffer sampling: the SCB pending_hint_* fields are the primary,
+ * overflow-proof yield signal; the ring buffer carries only every Nth
+ * hint for observability. 1 = every hint (pre-coalescing behavior).
+ */
+const volatile u32 hint_sample = 64;
+
 /*
  * ============================================================================
  * Statistics
@@ -61,6 +68,7 @@ struct morpheus_stats {
     u64 escalations_blocked;
     u64 ticks_total;
     u64 state_checks_skipped;  /* Hints skipped due to worker state */
+    u64 dsq_steals;            /* Tasks consumed from a remote LLC shard */
 };
 
 struct {
@@ -93,6 +101,48 @@ struct {
     __uint(max_entries, MORPHEUS_MAX_WORKERS);
 } worker_tid_map SEC(".maps");
 
+/*
+ * Registration generation - prefilter for the Delta #5 lazy-retry path
+ *
+ * The runtime bumps this after every worker_tid_map update. Unregistered
+ * tasks remember the generation they last probed at in their task_ctx, so
+ * the hash probe in morpheus_running re-runs only after a new
+ * registration instead of on every scheduling-in of every non-Morpheus
+ * task on the box.
+ */
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __type(key, u32);
+    __type(value, u64);
+    __uint(max_entries, 1);
+    __uint(map_flags, BPF_F_MMAPABLE);
+} reg_gen_map SEC(".maps");
+
+/*
+ * Syscall-free registration region (user-010)
+ *
+ * One slot per worker_id, mmap'd read-write by the runtime. Worker
+ * spawn/teardown are plain stores into a slot; the pressure timer
+ * sweeps the region, mirrors membership into worker_tid_map, and bumps
+ * reg_gen_map so the Delta #5 prefilter re-probes. The hash map becomes
+ * a kernel-internal cache; no bpf() syscalls on the spawn path.
+ */
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __type(key, u32);
+    __type(value, struct morpheus_reg_slot);
+    __uint(max_entries, MORPHEUS_MAX_WORKERS);
+    __uint(map_flags, BPF_F_MMAPABLE);
+} reg_region_map SEC(".maps");
+
+static __always_inline u64 get_reg_generation(void)
+{
+    u32 zero = 0;
+    u64 *gen = bpf_map_lookup_elem(&reg_gen_map, &zero);
+
+    return gen ? *gen : 0;
+}
+
 /*
  * ============================================================================
  * Delta #4: Global Pressure Aggregator
@@ -105,6 +155,32 @@ struct {
     __uint(max_entries, 1);
 } global_pressure_map SEC(".maps");
 
+/*
+ * Delta #4 (continued): Pressure aggregation timer
+ *
+ * The aggregator runs on a bpf_timer, NOT in morpheus_tick - the tick is
+ * the hot path and pressure only needs ~10Hz resolution. The callback
+ * samples per-shard DSQ depths, folds in the loader-fed PSI percentages
+ * already in global_pressure_map, and publishes the combined level into
+ * every worker SCB's kernel_pressure_level so checkpoints can self-pace
+ * without a map lookup of their own.
+ */
+struct pressure_timer {
+    struct bpf_timer timer;
+};
+
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __type(key, u32);
+    __type(value, struct pressure_timer);
+    __uint(max_entries, 1);
+} pressure_timer_map SEC(".maps");
+
+/* Set by the loader; used to normalize runqueue depth into a 0-100 level */
+const volatile u32 nr_cpus = 1;
+
+#define MORPHEUS_PRESSURE_INTERVAL_NS (100ULL * 1000 * 1000) /* 100ms */
+
 /*
  * Hint Ring Buffer - Kernel → Userspace events
  */
@@ -168,13 +244,65 @@ struct {
     __uint(max_entries, 1);
 } config_map SEC(".maps");
 
+/*
+ * Per-CPU config shadow
+ *
+ * morpheus_tick runs for every task on every tick; paying a shared
+ * config_map lookup there (and in enqueue/stopping) is measurable at
+ * scale even though the config changes maybe once per deployment. Each
+ * CPU keeps a private copy stamped with the generation it was copied at;
+ * userspace bumps config_generation after writing config_map, and the
+ * hot path refreshes its copy only when the stamps differ.
+ */
+struct config_cache {
+    struct morpheus_config cfg;
+    u64 generation;
+};
+
+struct {
+    __uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+    __type(key, u32);
+    __type(value, struct config_cache);
+    __uint(max_entries, 1);
+} config_cache_map SEC(".maps");
+
+/* Bumped by the loader after each config_map write (visible via bss) */
+u64 config_generation;
+
+static __always_inline void get_config(u64 *slice, u64 *grace)
+{
+    u32 zero = 0;
+    struct config_cache *cc = bpf_map_lookup_elem(&config_cache_map, &zero);
+
+    if (!cc) {
+        *slice = default_slice_ns;
+        *grace = default_grace_period_ns;
+        return;
+    }
+
+    u64 gen = config_generation;
+    if (cc->generation != gen) {
+        struct morpheus_config *cfg = bpf_map_lookup_elem(&config_map, &zero);
+
+        if (cfg)
+            cc->cfg = *cfg;
+        cc->generation = gen;
+    }
+
+    *slice = cc->cfg.slice_ns ?: default_slice_ns;
+    *grace = cc->cfg.grace_period_ns ?: default_grace_period_ns;
+}
+
 /*
  * Per-task state for tracking runtime
  */
 struct task_ctx {
     u64 last_tick_ns;
     u64 runtime_ns;
+    u64 slice_granted_ns; /* Slice handed out at last dispatch */
+    u64 reg_gen_seen;     /* Registration generation at last hash probe */
     u32 worker_id;
+    u32 escalation_strikes; /* Consecutive ticks the escalation gate passed */
     bool is_morpheus_worker;
 };
 
@@ -186,9 +314,121 @@ struct {
 } task_ctx_map SEC(".maps");
 
 /*
- * Dispatch queue
+ * Dispatch queues - one DSQ per LLC (last-level cache domain)
+ *
+ * A single global DSQ serializes every enqueue/dispatch on one queue lock,
+ * which collapses throughput scaling past ~32 CPUs. Instead we create one
+ * DSQ per LLC in morpheus_init: enqueue routes by the task's CPU, dispatch
+ * consumes the local shard first and falls back to stealing from sibling
+ * shards so no shard can strand work.
+ *
+ * The cpu → LLC mapping is topology-dependent, so the loader discovers it
+ * from sysfs and fills cpu_llc_map before attach. With nr_llcs == 1 (the
+ * default when topology detection fails) this degenerates to the old
+ * single-queue behavior.
+ */
+#define MORPHEUS_DSQ_BASE 0
+#define MORPHEUS_MAX_LLCS 64
+#define MORPHEUS_MAX_CPUS 1024
+
+/*
+ * EDF queue for workers holding a deadline reservation (user-029).
+ * Ordered by absolute deadline (reservation_token) and consumed before
+ * any LLC shard, so reserved work always jumps the line.
+ */
+#define MORPHEUS_DSQ_RESERVED (MORPHEUS_DSQ_BASE + MORPHEUS_MAX_LLCS)
+
+const volatile u32 nr_llcs = 1;
+
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __type(key, u32);   /* cpu */
+    __type(value, u32); /* llc id */
+    __uint(max_entries, MORPHEUS_MAX_CPUS);
+} cpu_llc_map SEC(".maps");
+
+static __always_inline u32 cpu_to_llc(s32 cpu)
+{
+    u32 key = cpu;
+    u32 *llc = bpf_map_lookup_elem(&cpu_llc_map, &key);
+    u32 id = llc ? *llc : 0;
+
+    /* Second bound is for the verifier: id indexes vtime_now[] */
+    if (id >= nr_llcs || id >= MORPHEUS_MAX_LLCS)
+        id = 0;
+    return id;
+}
+
+static __always_inline u64 cpu_to_dsq(s32 cpu)
+{
+    return MORPHEUS_DSQ_BASE + cpu_to_llc(cpu);
+}
+
+/*
+ * NUMA topology - filled by the loader from /sys/devices/system/node
+ *
+ * Worker hot state (mmap'd SCB lines, work-stealing deques) lives in one
+ * node's memory; migrating a worker across the interconnect trades cheap
+ * CPU time for remote-memory stalls. morpheus_select_cpu only accepts a
+ * cross-node pick from the default selector when the home node's shard
+ * is already backed up past cross_node_threshold.
+ */
+struct {
+    __uint(type, BPF_MAP_TYPE_ARRAY);
+    __type(key, u32);   /* cpu */
+    __type(value, u32); /* node id */
+    __uint(max_entries, MORPHEUS_MAX_CPUS);
+} cpu_node_map SEC(".maps");
+
+const volatile u32 nr_nodes = 1;
+/* Queued tasks on the home shard before a cross-node migration is allowed */
+const volatile u32 cross_node_threshold = 2;
+
+static __always_inline u32 cpu_to_node(s32 cpu)
+{
+    u32 key = cpu;
+    u32 *node = bpf_map_lookup_elem(&cpu_node_map, &key);
+
+    return node ? *node : 0;
+}
+
+/*
+ * Weighted virtual time (scx_simple vtime mode)
+ *
+ * Each shard is vtime-ordered instead of FIFO. Registered workers derive
+ * their weight from the advisory runtime_priority (0-1000) in their SCB:
+ * priority 500 maps to the default weight of 100, so a 1000-priority
+ * worker accrues vtime at half the rate of a default one and sorts ahead
+ * of it under contention. Unregistered tasks fall back to their cgroup /
+ * nice weight (p->scx.weight).
  */
-#define MORPHEUS_DSQ_ID 0
+static u64 vtime_now[MORPHEUS_MAX_LLCS]; /* per-shard vtime frontier */
+
+#define MORPHEUS_DEFAULT_WEIGHT 100
+
+/* Defined in the Helpers section below */
+static __always_inline struct morpheus_scb *get_scb(u32 worker_id);
+
+static __always_inline u64 task_weight(struct task_struct *p,
+                                       struct task_ctx *tctx)
+{
+    u64 weight;
+
+    if (tctx && tctx->is_morpheus_worker) {
+        struct morpheus_scb *scb = get_scb(tctx->worker_id);
+        if (scb) {
+            u32 prio = __sync_fetch_and_add(&scb->runtime_priority, 0);
+            if (prio > 1000)
+                prio = 1000;
+            /* 0-1000 priority -> 1-200 weight, 500 -> default 100 */
+            weight = prio / 5;
+            return weight ?: 1;
+        }
+    }
+
+    weight = p->scx.weight;
+    return weight ?: MORPHEUS_DEFAULT_WEIGHT;
+}
 
 /* User exit info for graceful shutdown */
 UEI_DEFINE(uei);
@@ -253,6 +493,7 @@ static __always_inline void emit_hint(u32 worker_id, u64 seq, u32 reason,
     hint->reason = reason;
     hint->target_tid = tid;
     hint->deadline_ns = deadline_ns;
+    hint->emit_ns = bpf_ktime_get_ns();
 
     bpf_ringbuf_submit(hint, 0);
 
@@ -300,6 +541,174 @@ static __always_inline void execute_escalation(struct task_struct *p,
     }
 }
 
+/*
+ * Sweep the registration region: mirror CLAIMED/RELEASING slots into
+ * worker_tid_map and bump the registration generation when membership
+ * changed. Runs from the pressure timer, never on a scheduling path.
+ */
+static __always_inline void sweep_reg_region(void)
+{
+    bool changed = false;
+    u32 i;
+
+    for (i = 0; i < MORPHEUS_MAX_WORKERS; i++) {
+        struct morpheus_reg_slot *slot;
+        u32 state, tid;
+
+        if (i >= max_workers)
+            break;
+        slot = bpf_map_lookup_elem(&reg_region_map, &i);
+        if (!slot)
+            break;
+
+        state = __sync_fetch_and_add(&slot->state, 0);
+        if (state == MORPHEUS_REG_SLOT_CLAIMED) {
+            tid = slot->tid;
+            if (!bpf_map_update_elem(&worker_tid_map, &tid, &i, BPF_ANY)) {
+                __sync_lock_test_and_set(&slot->state,
+                                         MORPHEUS_REG_SLOT_ACTIVE);
+                changed = true;
+            }
+        } else if (state == MORPHEUS_REG_SLOT_RELEASING) {
+            tid = slot->tid;
+            bpf_map_delete_elem(&worker_tid_map, &tid);
+            __sync_lock_test_and_set(&slot->state, MORPHEUS_REG_SLOT_FREE);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        u32 zero = 0;
+        u64 *gen = bpf_map_lookup_elem(&reg_gen_map, &zero);
+
+        if (gen)
+            __sync_fetch_and_add(gen, 1);
+    }
+}
+
+/*
+ * Delta #4: Pressure aggregation timer callback
+ *
+ * Runs every MORPHEUS_PRESSURE_INTERVAL_NS, entirely off the tick path.
+ */
+static int pressure_timer_cb(void *map, int *key, struct bpf_timer *timer)
+{
+    struct morpheus_global_pressure *gp;
+    u32 zero = 0, i, level;
+    u32 depth = 0;
+
+    /* Pick up syscall-free registrations first (user-010) */
+    sweep_reg_region();
+
+    /*
+     * Reservation protocol: when any reservation's deadline is within
+     * two pressure intervals, push MORPHEUS_HINT_DEADLINE at RUNNING
+     * workers that do NOT hold a reservation, so competing work clears
+     * the CPUs early. Runs here, never on a scheduling path.
+     */
+    {
+        u64 now_ns = bpf_ktime_get_ns();
+        u64 horizon = now_ns + 2 * MORPHEUS_PRESSURE_INTERVAL_NS;
+        bool urgent = false;
+        u32 w;
+
+        for (w = 0; w < MORPHEUS_MAX_WORKERS; w++) {
+            struct morpheus_scb *scb;
+            u64 deadline;
+
+            if (w >= max_workers)
+                break;
+            scb = bpf_map_lookup_elem(&scb_map, &w);
+            if (!scb)
+                break;
+            deadline = __sync_fetch_and_add(&scb->reservation_token, 0);
+            if (deadline && deadline < horizon) {
+                urgent = true;
+                break;
+            }
+        }
+
+        if (urgent) {
+            for (w = 0; w < MORPHEUS_MAX_WORKERS; w++) {
+                struct morpheus_scb *scb;
+                u64 preempt, acked;
+
+                if (w >= max_workers)
+                    break;
+                scb = bpf_map_lookup_elem(&scb_map, &w);
+                if (!scb)
+                    break;
+                if (__sync_fetch_and_add(&scb->reservation_token, 0))
+                    continue; /* reserved workers keep running */
+                if (__sync_fetch_and_add(&scb->worker_state, 0) !=
+                    MORPHEUS_WORKER_STATE_RUNNING)
+                    continue;
+
+                /* Don't stack requests on an unacked one */
+                preempt = __sync_fetch_and_add(&scb->preempt_seq, 0);
+                acked = __sync_fetch_and_add(&scb->last_ack_seq, 0);
+                if (preempt != acked)
+                    continue;
+
+                __sync_lock_test_and_set(&scb->pending_hint_reason,
+                                         MORPHEUS_HINT_DEADLINE);
+                __sync_lock_test_and_set(&scb->pending_hint_deadline_ns,
+                                         horizon);
+                __sync_add_and_fetch(&scb->preempt_seq, 1);
+            }
+        }
+    }
+
+    /* Aggregate queued work across all shards */
+    for (i = 0; i < MORPHEUS_MAX_LLCS; i++) {
+        if (i >= nr_llcs)
+            break;
+        depth += scx_bpf_dsq_nr_queued(MORPHEUS_DSQ_BASE + i);
+    }
+
+    gp = bpf_map_lookup_elem(&global_pressure_map, &zero);
+    if (gp) {
+        gp->runqueue_depth = depth;
+
+        /*
+         * Combine loader-fed PSI with queue depth: a runqueue twice as
+         * deep as the machine is 100% pressure, and either signal alone
+         * is enough to push workers toward eager yields.
+         */
+        level = depth * 100 / (nr_cpus ? nr_cpus * 2 : 2);
+        if (level > 100)
+            level = 100;
+        if (gp->cpu_pressure_pct > level)
+            level = gp->cpu_pressure_pct;
+
+        /*
+         * Fan the combined level out to worker SCBs. Store only on
+         * change: kernel_pressure_level lives on the checkpoint-critical
+         * cache line, whose contract (SCB v2) is that the kernel writes
+         * it only when it actually wants something - an unconditional
+         * xchg here would dirty every worker's checkpoint line 10x/sec
+         * in the common steady state of an unchanged (usually zero)
+         * level.
+         */
+        for (i = 0; i < MORPHEUS_MAX_WORKERS; i++) {
+            struct morpheus_scb *scb;
+
+            if (i >= max_workers)
+                break;
+            scb = bpf_map_lookup_elem(&scb_map, &i);
+            if (!scb)
+                break;
+            /* Plain read on purpose: an atomic RMW read would itself
+             * take the line exclusive, which is what we're avoiding. */
+            if (scb->kernel_pressure_level != level)
+                __sync_lock_test_and_set(&scb->kernel_pressure_level, level);
+        }
+    }
+
+    bpf_timer_start(timer, MORPHEUS_PRESSURE_INTERVAL_NS, 0);
+    return 0;
+}
+
 /*
  * ============================================================================
  * sched_ext ops
@@ -308,7 +717,49 @@ static __always_inline void execute_escalation(struct task_struct *p,
 
 s32 BPF_STRUCT_OPS_SLEEPABLE(morpheus_init)
 {
-    return scx_bpf_create_dsq(MORPHEUS_DSQ_ID, -1);
+    struct pressure_timer *pt;
+    u32 zero = 0;
+    u32 i;
+    s32 ret;
+
+    /*
+     * Stamp the SCB layout version into every slot so runtimes can
+     * verify they speak the same layout before attaching (SCB v2).
+     */
+    for (i = 0; i < MORPHEUS_MAX_WORKERS; i++) {
+        struct morpheus_scb *scb;
+
+        if (i >= max_workers)
+            break;
+        scb = bpf_map_lookup_elem(&scb_map, &i);
+        if (!scb)
+            break;
+        __sync_lock_test_and_set(&scb->version, MORPHEUS_SCB_VERSION);
+    }
+
+    for (i = 0; i < MORPHEUS_MAX_LLCS; i++) {
+        if (i >= nr_llcs)
+            break;
+        ret = scx_bpf_create_dsq(MORPHEUS_DSQ_BASE + i, -1);
+        if (ret)
+            return ret;
+    }
+
+    ret = scx_bpf_create_dsq(MORPHEUS_DSQ_RESERVED, -1);
+    if (ret)
+        return ret;
+
+    /* Arm the pressure aggregation timer (Delta #4) */
+    pt = bpf_map_lookup_elem(&pressure_timer_map, &zero);
+    if (!pt)
+        return -ENOMEM;
+    ret = bpf_timer_init(&pt->timer, &pressure_timer_map, CLOCK_MONOTONIC);
+    if (ret)
+        return ret;
+    ret = bpf_timer_set_callback(&pt->timer, pressure_timer_cb);
+    if (ret)
+        return ret;
+    return bpf_timer_start(&pt->timer, MORPHEUS_PRESSURE_INTERVAL_NS, 0);
 }
 
 s32 BPF_STRUCT_OPS(morpheus_init_task, struct task_struct *p,
@@ -325,6 +776,9 @@ s32 BPF_STRUCT_OPS(morpheus_init_task, struct task_struct *p,
 
     tctx->last_tick_ns = 0;
     tctx->runtime_ns = 0;
+    tctx->slice_granted_ns = 0;
+    tctx->escalation_strikes = 0;
+    tctx->reg_gen_seen = get_reg_generation();
 
     /* Check if this task is a registered Morpheus worker */
     worker_id_ptr = bpf_map_lookup_elem(&worker_tid_map, &pid);
@@ -342,13 +796,61 @@ s32 BPF_STRUCT_OPS(morpheus_init_task, struct task_struct *p,
 s32 BPF_STRUCT_OPS(morpheus_select_cpu, struct task_struct *p, s32 prev_cpu,
                    u64 wake_flags)
 {
+    struct task_ctx *tctx = get_task_ctx(p);
     bool is_idle = false;
     s32 cpu;
 
+    /*
+     * The default selector already prefers the previous CPU and its SMT
+     * sibling, then walks outward to any idle core - including across
+     * NUMA nodes. Sanity-check its pick against topology below.
+     */
     cpu = scx_bpf_select_cpu_dfl(p, prev_cpu, wake_flags, &is_idle);
-    if (is_idle)
+
+    if (nr_nodes > 1 && cpu != prev_cpu) {
+        u32 target_node = cpu_to_node(cpu);
+        u32 home_node = cpu_to_node(prev_cpu);
+
+        /* Per-worker affinity hint overrides the implicit home node */
+        if (tctx && tctx->is_morpheus_worker) {
+            struct morpheus_scb *scb = get_scb(tctx->worker_id);
+            if (scb) {
+                u32 pref = __sync_fetch_and_add(&scb->preferred_node, 0);
+                if (pref)
+                    home_node = pref - 1;
+            }
+        }
+
+        /*
+         * Only cross the interconnect when the home LLC shard is backed
+         * up enough that remote-memory stalls beat queueing delay. The
+         * cpumask check matters: affinity may have changed since the
+         * task last ran on prev_cpu.
+         */
+        if (target_node != home_node &&
+            bpf_cpumask_test_cpu(prev_cpu, p->cpus_ptr) &&
+            scx_bpf_dsq_nr_queued(cpu_to_dsq(prev_cpu)) <=
+                (s32)cross_node_threshold) {
+            /*
+             * The default picker already claimed the remote CPU's idle
+             * flag; since nothing will be dispatched there, kick it
+             * idle so it re-asserts the flag instead of sitting
+             * invisible to all later idle selection.
+             */
+            if (is_idle)
+                scx_bpf_kick_cpu(cpu, SCX_KICK_IDLE);
+
+            cpu = prev_cpu;
+            is_idle = scx_bpf_test_and_clear_cpu_idle(prev_cpu);
+        }
+    }
+
+    if (is_idle) {
+        if (tctx)
+            tctx->slice_granted_ns = default_slice_ns;
         // Dispatch directly to the idle CPU's local queue
         scx_bpf_dispatch(p, SCX_DSQ_LOCAL, default_slice_ns, 0);
+    }
 
     return cpu;
 }
@@ -360,16 +862,75 @@ void BPF_STRUCT_OPS(morpheus_enqueue, struct task_struct *p, u64 enq_flags)
     if (tctx)
         tctx->runtime_ns = 0;
 
-    u32 zero = 0;
-    struct morpheus_config *cfg = bpf_map_lookup_elem(&config_map, &zero);
-    u64 slice = cfg ? cfg->slice_ns : default_slice_ns;
-    
-    scx_bpf_dispatch(p, MORPHEUS_DSQ_ID, slice, enq_flags);
+    u64 slice, grace;
+    get_config(&slice, &grace);
+
+    /*
+     * Reservation protocol: a worker holding a deadline reservation is
+     * dispatched EDF - the reserved DSQ is vtime-ordered by absolute
+     * deadline and drained before any shard.
+     */
+    if (tctx && tctx->is_morpheus_worker) {
+        struct morpheus_scb *scb = get_scb(tctx->worker_id);
+        if (scb) {
+            u64 deadline = __sync_fetch_and_add(&scb->reservation_token, 0);
+            if (deadline) {
+                tctx->slice_granted_ns = slice;
+                scx_bpf_dispatch_vtime(p, MORPHEUS_DSQ_RESERVED, slice,
+                                       deadline, enq_flags);
+                return;
+            }
+        }
+    }
+
+    /* Route to the shard of the CPU the task last ran on */
+    s32 cpu = scx_bpf_task_cpu(p);
+    u32 llc = cpu_to_llc(cpu);
+    u64 vtime = p->scx.dsq_vtime;
+
+    if (tctx)
+        tctx->slice_granted_ns = slice;
+
+    /*
+     * Cap how much vtime a long-sleeping task can bank; otherwise it
+     * would starve the shard when it wakes (same clamp as scx_simple).
+     */
+    if (time_before(vtime, vtime_now[llc] - slice))
+        vtime = vtime_now[llc] - slice;
+
+    scx_bpf_dispatch_vtime(p, MORPHEUS_DSQ_BASE + llc, slice, vtime,
+                           enq_flags);
 }
 
 void BPF_STRUCT_OPS(morpheus_dispatch, s32 cpu, struct task_struct *prev)
 {
-    scx_bpf_consume(MORPHEUS_DSQ_ID);
+    u64 local_dsq = cpu_to_dsq(cpu);
+    u32 local_llc = local_dsq - MORPHEUS_DSQ_BASE;
+    u32 i;
+
+    /* Deadline reservations (EDF order) jump every shard */
+    if (scx_bpf_consume(MORPHEUS_DSQ_RESERVED))
+        return;
+
+    /* Local LLC shard first */
+    if (scx_bpf_consume(local_dsq))
+        return;
+
+    /*
+     * Steal from sibling shards so no shard strands work. Rotate the scan
+     * from the local shard so steal traffic spreads instead of piling
+     * onto shard 0.
+     */
+    for (i = 1; i < MORPHEUS_MAX_LLCS; i++) {
+        if (i >= nr_llcs)
+            break;
+        if (scx_bpf_consume(MORPHEUS_DSQ_BASE + (local_llc + i) % nr_llcs)) {
+            struct morpheus_stats *stats = get_stats();
+            if (stats)
+                __sync_fetch_and_add(&stats->dsq_steals, 1);
+            return;
+        }
+    }
 }
 
 void BPF_STRUCT_OPS(morpheus_running, struct task_struct *p)
@@ -377,25 +938,58 @@ void BPF_STRUCT_OPS(morpheus_running, struct task_struct *p)
     struct task_ctx *tctx = get_task_ctx(p);
 
     if (tctx) {
-        /* Delta #5: Dynamic Registration Support */
+        /*
+         * Delta #5: Dynamic Registration Support
+         *
+         * Prefiltered by the registration generation: the hash probe
+         * re-runs only after the runtime has registered someone new,
+         * so tasks that will never be Morpheus workers pay a single
+         * array read and a predictable branch here.
+         */
         if (!tctx->is_morpheus_worker) {
-            u32 pid = BPF_CORE_READ(p, pid);
-            u32 *worker_id_ptr = bpf_map_lookup_elem(&worker_tid_map, &pid);
-            if (worker_id_ptr) {
-                tctx->worker_id = *worker_id_ptr;
-                tctx->is_morpheus_worker = true;
+            u64 gen = get_reg_generation();
+
+            /*
+             * gen == 0 means no runtime has ever bumped the counter
+             * (e.g. an older runtime without reg_gen_map support);
+             * fall back to probing every time like before.
+             */
+            if (gen == 0 || gen != tctx->reg_gen_seen) {
+                u32 pid = BPF_CORE_READ(p, pid);
+                u32 *worker_id_ptr = bpf_map_lookup_elem(&worker_tid_map, &pid);
+
+                tctx->reg_gen_seen = gen;
+                if (worker_id_ptr) {
+                    tctx->worker_id = *worker_id_ptr;
+                    tctx->is_morpheus_worker = true;
+                }
             }
         }
 
-        tctx->last_tick_ns = bpf_ktime_get_ns();
+        if (tctx->is_morpheus_worker)
+            tctx->last_tick_ns = bpf_ktime_get_ns();
     }
+
+    /* Advance the shard's vtime frontier (scx_simple vtime mode) */
+    u32 llc = cpu_to_llc(scx_bpf_task_cpu(p));
+    if (time_before(vtime_now[llc], p->scx.dsq_vtime))
+        vtime_now[llc] = p->scx.dsq_vtime;
 }
 
 void BPF_STRUCT_OPS(morpheus_stopping, struct task_struct *p, bool runnable)
 {
     struct task_ctx *tctx = get_task_ctx(p);
     struct morpheus_scb *scb;
-    u64 now, delta;
+    u64 now, delta = 0;
+
+    /*
+     * Charge weighted vtime for the slice actually consumed so the next
+     * enqueue sorts this task correctly against its shard.
+     */
+    u64 granted = tctx && tctx->slice_granted_ns ? tctx->slice_granted_ns
+                                                 : default_slice_ns;
+    u64 used = granted > p->scx.slice ? granted - p->scx.slice : 0;
+    p->scx.dsq_vtime += used * MORPHEUS_DEFAULT_WEIGHT / task_weight(p, tctx);
 
     if (!tctx || !tctx->is_morpheus_worker)
         return;
@@ -423,16 +1017,22 @@ void BPF_STRUCT_OPS(morpheus_tick, struct task_struct *p)
 {
     struct task_ctx *tctx = get_task_ctx(p);
     struct morpheus_scb *scb;
-    struct morpheus_stats *stats = get_stats();
+    struct morpheus_stats *stats;
     u64 now, delta, preempt_seq, last_ack_seq, deadline;
     u32 worker_state, is_critical, escapable, escalation_policy, tid;
 
-    if (stats)
-        __sync_fetch_and_add(&stats->ticks_total, 1);
-
+    /*
+     * Fast exit for non-Morpheus tasks: one task-storage read and a
+     * predictable branch. Stats accounting (ticks_total now counts
+     * worker ticks only) happens past this point.
+     */
     if (!tctx || !tctx->is_morpheus_worker)
         return;
 
+    stats = get_stats();
+    if (stats)
+        __sync_fetch_and_add(&stats->ticks_total, 1);
+
     now = bpf_ktime_get_ns();
     if (tctx->last_tick_ns > 0) {
         delta = now - tctx->last_tick_ns;
@@ -452,23 +1052,33 @@ void BPF_STRUCT_OPS(morpheus_tick, struct task_struct *p)
         return;
     }
 
-    /* Get configuration */
-    u32 zero = 0;
-    struct morpheus_config *cfg = bpf_map_lookup_elem(&config_map, &zero);
-    u64 slice = cfg ? cfg->slice_ns : default_slice_ns;
-    u64 grace = cfg ? cfg->grace_period_ns : default_grace_period_ns;
+    /* Get configuration (per-CPU cached, refreshed on generation bump) */
+    u64 slice, grace;
+    get_config(&slice, &grace);
 
     /* Check if we exceeded the slice */
     if (tctx->runtime_ns > slice) {
+        deadline = now + grace;
+
+        /*
+         * Coalesced hint delivery: publish reason + deadline into the
+         * SCB BEFORE bumping preempt_seq, so a runtime observing the
+         * new seq is guaranteed matching values. This is the primary
+         * yield signal and cannot overflow.
+         */
+        __sync_lock_test_and_set(&scb->pending_hint_reason,
+                                 MORPHEUS_HINT_BUDGET);
+        __sync_lock_test_and_set(&scb->pending_hint_deadline_ns, deadline);
+
         /* Increment preempt_seq to signal yield request */
         preempt_seq = __sync_add_and_fetch(&scb->preempt_seq, 1);
 
         tid = BPF_CORE_READ(p, pid);
 
-        /* Emit hint via ring buffer */
-        deadline = now + grace;
-        emit_hint(tctx->worker_id, preempt_seq, MORPHEUS_HINT_BUDGET,
-                  tid, deadline);
+        /* Ring buffer is a sampled observability stream only */
+        if (hint_sample <= 1 || preempt_seq % hint_sample == 0)
+            emit_hint(tctx->worker_id, preempt_seq, MORPHEUS_HINT_BUDGET,
+                      tid, deadline);
 
         /* Delta #1: Only escalate if in enforced mode */
         if (scheduler_mode != MORPHEUS_MODE_ENFORCED) {
@@ -502,15 +1112,30 @@ void BPF_STRUCT_OPS(morpheus_tick, struct task_struct *p)
             tctx->runtime_ns > (slice + grace) &&
             escalation_policy != MORPHEUS_ESCALATION_NONE) {
 
+            /*
+             * Confirmation window: runtimes in lazy-publication mode
+             * only raise is_in_critical_section once they observe the
+             * pending yield request, so give the worker one more tick
+             * to publish before acting on the flag's absence.
+             */
+            if (tctx->escalation_strikes < 1) {
+                tctx->escalation_strikes++;
+                return;
+            }
+            tctx->escalation_strikes = 0;
+
             if (debug_mode)
                 bpf_printk("morpheus: escalating worker %u (tid=%d, runtime=%llu, policy=%u)",
                            tctx->worker_id, tid, tctx->runtime_ns, escalation_policy);
 
             /* Delta #3: Execute based on policy */
             execute_escalation(p, escalation_policy, stats);
-        } else if (!escapable || is_critical) {
-            if (stats)
-                __sync_fetch_and_add(&stats->escalations_blocked, 1);
+        } else {
+            tctx->escalation_strikes = 0;
+            if (!escapable || is_critical) {
+                if (stats)
+                    __sync_fetch_and_add(&stats->escalations_blocked, 1);
+            }
         }
     }
 }
@@ -12,6 +12,7 @@ mod bpf {
 
 use anyhow::{Context, Result};
 use clap::Parser;
+use crossbeam::queue::ArrayQueue;
 use libbpf_rs::skel::{OpenSkel, Skel, SkelBuilder};
 use libbpf_rs::MapCore;
 use libbpf_rs::RingBufferBuilder;
@@ -19,7 +20,6 @@ use std::collections::HashMap;
 use std::mem::MaybeUninit;
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::sync::Arc;
-use std::sync::Mutex;
 use std::time::Duration;
 use tracing::{info, Level};
 use tracing_subscriber::FmtSubscriber;
@@ -43,15 +43,161 @@ struct MorpheusConfig {
     grace_period_ns: u64,
 }
 
+/// Bounded hand-off queue between the ring buffer callback and the
+/// penalty thread. The callback must never block on cgroup I/O.
+const PENALTY_QUEUE_CAPACITY: usize = 1024;
+
+/// How long a throttle stays applied before the quota is restored.
+const PENALTY_DURATION: Duration = Duration::from_secs(5);
+
+/// Upper bound on the pid -> cgroup path cache before it is pruned.
+const CGROUP_CACHE_LIMIT: usize = 4096;
+
+/// An applied cgroup throttle awaiting expiry
+struct CgroupPenalty {
+    /// Quota string to restore on expiry
+    original_quota: String,
+    /// Open cpu.max file, reused for apply and restore
+    max_file: std::fs::File,
+    /// When to lift the throttle
+    expires_at: std::time::Instant,
+}
+
+/// Applies and expires cgroup CPU quotas in response to escalation events.
+///
+/// Owned exclusively by the penalty thread - no locks. The ring buffer
+/// callback only pushes events into the bounded queue; this manager
+/// batches them per cgroup, deduplicates repeats against the active
+/// penalty table, and reuses resolved paths and file descriptors so the
+/// overload path does as little work as possible.
 struct PenaltyManager {
-    // pid -> (original_quota, expiration_time)
-    active_penalties: HashMap<u32, (String, std::time::Instant)>,
+    /// cgroup path -> active penalty (also the dedupe table)
+    active_penalties: HashMap<String, CgroupPenalty>,
+    /// pid -> resolved cgroup path
+    cgroup_cache: HashMap<u32, String>,
 }
 
 impl PenaltyManager {
     fn new() -> Self {
         Self {
             active_penalties: HashMap::new(),
+            cgroup_cache: HashMap::new(),
+        }
+    }
+
+    /// Resolve (and cache) the cgroup path for a pid
+    fn resolve_cgroup(&mut self, pid: u32) -> Option<String> {
+        if let Some(path) = self.cgroup_cache.get(&pid) {
+            return Some(path.clone());
+        }
+
+        let path = find_cgroup_path(pid).ok()?;
+        if self.cgroup_cache.len() >= CGROUP_CACHE_LIMIT {
+            self.cgroup_cache.clear();
+        }
+        self.cgroup_cache.insert(pid, path.clone());
+        Some(path)
+    }
+
+    /// Apply a drained batch of escalation events
+    ///
+    /// Events are coalesced per cgroup: a cgroup that is already
+    /// throttled gets its expiry extended instead of a second write.
+    fn apply_batch(&mut self, events: &[MorpheusEscalationEvent]) {
+        let now = std::time::Instant::now();
+
+        for event in events {
+            let path = match self.resolve_cgroup(event.pid) {
+                Some(path) => path,
+                None => continue,
+            };
+
+            if let Some(penalty) = self.active_penalties.get_mut(&path) {
+                // Already throttled: refresh the window, skip the write
+                penalty.expires_at = now + PENALTY_DURATION;
+                continue;
+            }
+
+            self.throttle(event, &path, now);
+        }
+    }
+
+    fn throttle(&mut self, event: &MorpheusEscalationEvent, path: &str, now: std::time::Instant) {
+        use std::io::{Read, Seek, SeekFrom, Write};
+
+        // The BPF side stamps events with bpf_ktime_get_ns (monotonic);
+        // the gap to now is the ringbuf + queue + batch latency of the
+        // penalty pipeline itself.
+        let mut ts = libc::timespec { tv_sec: 0, tv_nsec: 0 };
+        unsafe { libc::clock_gettime(libc::CLOCK_MONOTONIC, &mut ts) };
+        let now_ns = (ts.tv_sec as u64) * 1_000_000_000 + ts.tv_nsec as u64;
+        let pipeline_delay_us = now_ns.saturating_sub(event.timestamp) / 1000;
+
+        info!(
+            "ESCALATION: Worker {} (PID {}) - Severity {} (pipeline delay {}us)",
+            event.worker_id, event.pid, event.severity, pipeline_delay_us
+        );
+
+        let max_path = format!("{}/cpu.max", path);
+        let mut max_file = match std::fs::OpenOptions::new()
+            .read(true)
+            .write(true)
+            .open(&max_path)
+        {
+            Ok(file) => file,
+            Err(e) => {
+                tracing::error!("  -> Failed to open {}: {}", max_path, e);
+                return;
+            }
+        };
+
+        let mut original_quota = String::new();
+        if max_file.read_to_string(&mut original_quota).is_err() {
+            return;
+        }
+
+        // Write penalty (1000 100000 = 1%)
+        if max_file.seek(SeekFrom::Start(0)).is_ok() && max_file.write_all(b"1000 100000").is_ok()
+        {
+            info!("  -> Throttled cgroup {} to 1%", max_path);
+            self.active_penalties.insert(
+                path.to_string(),
+                CgroupPenalty {
+                    original_quota,
+                    max_file,
+                    expires_at: now + PENALTY_DURATION,
+                },
+            );
+        } else {
+            tracing::error!("  -> Failed to write to {}", max_path);
+        }
+    }
+
+    /// Restore quotas for penalties whose window has passed
+    fn expire(&mut self) {
+        use std::io::{Seek, SeekFrom, Write};
+
+        let now = std::time::Instant::now();
+        let expired: Vec<String> = self
+            .active_penalties
+            .iter()
+            .filter(|(_, p)| now >= p.expires_at)
+            .map(|(path, _)| path.clone())
+            .collect();
+
+        for path in expired {
+            if let Some(mut penalty) = self.active_penalties.remove(&path) {
+                if penalty.max_file.seek(SeekFrom::Start(0)).is_ok()
+                    && penalty
+                        .max_file
+                        .write_all(penalty.original_quota.as_bytes())
+                        .is_ok()
+                {
+                    info!("  -> Restored quota for cgroup {}", path);
+                } else {
+                    tracing::error!("  -> Failed to restore quota for cgroup {}", path);
+                }
+            }
         }
     }
 }
@@ -87,6 +233,11 @@ struct Args {
     /// Enable enforcement mode (cgroup throttling and kicking)
     #[arg(long)]
     enforce: bool,
+
+    /// Emit every Nth hint to the ring buffer (1 = every hint).
+    /// The SCB pending_hint fields are the primary delivery path.
+    #[arg(long, default_value_t = 64)]
+    hint_sample: u32,
 }
 
 fn main() -> Result<()> {
@@ -123,9 +274,53 @@ fn main() -> Result<()> {
         info!("Enforcement mode DISABLED (Observer only)");
     }
 
+    // Shard the dispatch queues by LLC. Topology must be known before load
+    // so morpheus_init creates the right number of DSQs.
+    let (cpu_llcs, nr_llcs) = detect_llc_topology();
+    open_skel.maps.rodata_data.nr_llcs = nr_llcs;
+    info!("  DSQ shards: {} (one per LLC)", nr_llcs);
+
+    open_skel.maps.rodata_data.hint_sample = args.hint_sample;
+
+    // The BPF pressure timer normalizes runqueue depth against this
+    let num_cpus = std::thread::available_parallelism()
+        .map(|n| n.get())
+        .unwrap_or(1) as u32;
+    open_skel.maps.rodata_data.nr_cpus = num_cpus;
+
+    // NUMA-aware CPU selection: gate cross-node migrations on home-shard
+    // depth. Threshold scales with node width so wide nodes tolerate
+    // proportionally more queueing before shipping work across.
+    let (cpu_nodes, nr_nodes) = detect_node_topology(num_cpus as usize);
+    open_skel.maps.rodata_data.nr_nodes = nr_nodes;
+    open_skel.maps.rodata_data.cross_node_threshold = (num_cpus / nr_nodes.max(1) / 4).max(2);
+    if nr_nodes > 1 {
+        info!("  NUMA nodes: {}", nr_nodes);
+    }
+
     // Load the skeleton
     let mut skel = open_skel.load().context("Failed to load BPF program")?;
 
+    // Publish the cpu -> LLC routing table before any task is enqueued
+    for (cpu, llc) in cpu_llcs.iter().enumerate() {
+        let key = (cpu as u32).to_ne_bytes();
+        let value = llc.to_ne_bytes();
+        skel.maps
+            .cpu_llc_map
+            .update(&key, &value, libbpf_rs::MapFlags::ANY)
+            .context("Failed to update cpu_llc_map")?;
+    }
+
+    // ... and the cpu -> NUMA node table for the cross-node gate
+    for (cpu, node) in cpu_nodes.iter().enumerate() {
+        let key = (cpu as u32).to_ne_bytes();
+        let value = node.to_ne_bytes();
+        skel.maps
+            .cpu_node_map
+            .update(&key, &value, libbpf_rs::MapFlags::ANY)
+            .context("Failed to update cpu_node_map")?;
+    }
+
     // Attach the scheduler
     skel.attach().context("Failed to attach sched_ext ops")?;
 
@@ -138,6 +333,9 @@ fn main() -> Result<()> {
 
         let tid_map_path = format!("{}/worker_tid_map", pin_dir);
         let scb_map_path = format!("{}/scb_map", pin_dir);
+        let reg_gen_path = format!("{}/reg_gen_map", pin_dir);
+        let reg_region_path = format!("{}/reg_region_map", pin_dir);
+        let hint_ringbuf_path = format!("{}/hint_ringbuf", pin_dir);
 
         skel.maps
             .worker_tid_map
@@ -147,10 +345,25 @@ fn main() -> Result<()> {
             .scb_map
             .pin(&scb_map_path)
             .context("Failed to pin scb_map")?;
+        skel.maps
+            .reg_gen_map
+            .pin(&reg_gen_path)
+            .context("Failed to pin reg_gen_map")?;
+        skel.maps
+            .reg_region_map
+            .pin(&reg_region_path)
+            .context("Failed to pin reg_region_map")?;
+        skel.maps
+            .hint_ringbuf
+            .pin(&hint_ringbuf_path)
+            .context("Failed to pin hint_ringbuf")?;
 
         info!("BPF maps pinned to {}", pin_dir);
         info!("  worker_tid_map: {}", tid_map_path);
         info!("  scb_map: {}", scb_map_path);
+        info!("  reg_gen_map: {}", reg_gen_path);
+        info!("  reg_region_map: {}", reg_region_path);
+        info!("  hint_ringbuf: {}", hint_ringbuf_path);
     }
 
     // Set up graceful shutdown
@@ -169,15 +382,19 @@ fn main() -> Result<()> {
         None
     };
 
-    // Start escalation monitor
-    let penalty_manager = Arc::new(Mutex::new(PenaltyManager::new()));
-    let pm_clone = penalty_manager.clone();
+    // Start the escalation pipeline: the ring buffer callback does a
+    // lock-free push into a bounded queue; a dedicated penalty thread
+    // batches, deduplicates, and applies cgroup throttles. Cgroup I/O
+    // must never block the thread draining the ring buffer - that backs
+    // up and drops events exactly when the system is most overloaded.
+    let penalty_queue = Arc::new(ArrayQueue::<MorpheusEscalationEvent>::new(
+        PENALTY_QUEUE_CAPACITY,
+    ));
+    let penalty_drops = Arc::new(std::sync::atomic::AtomicU64::new(0));
 
-    // We need a separate RingBuffer for the escalation map
-    // Note: libbpf-rs RingBuffer APIs usually take a callback.
-    // We'll spawn a thread to poll it.
     let mut rb_builder = RingBufferBuilder::new();
-    let pm_clone_rb = pm_clone.clone();
+    let queue_push = penalty_queue.clone();
+    let drops_push = penalty_drops.clone();
     rb_builder
         .add(&skel.maps.escalation_ringbuf, move |data: &[u8]| {
             if data.len() < std::mem::size_of::<MorpheusEscalationEvent>() {
@@ -186,7 +403,9 @@ fn main() -> Result<()> {
             let event = unsafe {
                 std::ptr::read_unaligned(data.as_ptr() as *const MorpheusEscalationEvent)
             };
-            handle_escalation_event(&event, &pm_clone_rb);
+            if queue_push.push(event).is_err() {
+                drops_push.fetch_add(1, Ordering::Relaxed);
+            }
             0
         })
         .context("Failed to add escalation ringbuf")?;
@@ -200,27 +419,68 @@ fn main() -> Result<()> {
             if let Err(e) = ringbuf.poll(Duration::from_millis(100)) {
                 tracing::warn!("Ringbuf poll error: {}", e);
             }
-            // Check for expired penalties
-            check_expired_penalties(&pm_clone);
         }
     });
 
+    // Penalty thread: drains the queue in batches and owns all cgroup I/O
+    let queue_drain = penalty_queue.clone();
+    let drops_drain = penalty_drops.clone();
+    let run_penalty = running.clone();
+    std::thread::spawn(move || {
+        let mut manager = PenaltyManager::new();
+        let mut batch = Vec::with_capacity(PENALTY_QUEUE_CAPACITY);
+
+        while run_penalty.load(Ordering::SeqCst) {
+            batch.clear();
+            while let Some(event) = queue_drain.pop() {
+                batch.push(event);
+            }
+
+            manager.apply_batch(&batch);
+            manager.expire();
+
+            let dropped = drops_drain.swap(0, Ordering::Relaxed);
+            if dropped > 0 {
+                tracing::warn!("penalty queue overflow: {} events dropped", dropped);
+            }
+
+            std::thread::sleep(Duration::from_millis(10));
+        }
+    });
+
+    // Dedicated PSI feeder thread (Delta #4): the BPF pressure timer owns
+    // runqueue_depth, but PSI lives in /proc and must be fed from here.
+    let pressure_map = libbpf_rs::MapHandle::try_from(&skel.maps.global_pressure_map)
+        .context("Failed to clone global_pressure_map handle")?;
+    let run_psi = running.clone();
+    std::thread::spawn(move || {
+        while run_psi.load(Ordering::SeqCst) {
+            if let Err(e) = update_global_pressure(&pressure_map) {
+                tracing::warn!("Failed to update pressure: {}", e);
+            }
+            std::thread::sleep(Duration::from_secs(1));
+        }
+    });
+
+    // Closed-loop slice controller seeded from the CLI defaults; push the
+    // initial config so the CLI flags take effect before the first step.
+    let mut controller =
+        SliceController::new(args.slice_ms * 1_000_000, args.grace_ms * 1_000_000);
+    controller.push(&mut skel)?;
+
+    // Streaming per-CPU stats aggregation (deltas survive reloads)
+    let mut stats_aggregator = StatsAggregator::new();
+
     while running.load(Ordering::SeqCst) {
         if let Some(interval) = stats_interval {
             std::thread::sleep(interval);
-            // Update global pressure from PSI
-            if let Err(e) = update_global_pressure(&skel) {
-                tracing::warn!("Failed to update pressure: {}", e);
-            }
-            if let Err(e) = adaptive_tune(&skel, args.slice_ms * 1_000_000, args.grace_ms * 1_000_000) {
+            if let Err(e) = controller.tune(&mut skel) {
                 tracing::warn!("Failed to auto-tune: {}", e);
             }
-            print_stats(&skel)?;
+            print_stats(&skel, &mut stats_aggregator)?;
         } else {
             std::thread::sleep(Duration::from_secs(1));
-            // Still update pressure even if stats disabled
-            let _ = update_global_pressure(&skel);
-            let _ = adaptive_tune(&skel, args.slice_ms * 1_000_000, args.grace_ms * 1_000_000);
+            let _ = controller.tune(&mut skel);
         }
     }
 
@@ -228,84 +488,304 @@ fn main() -> Result<()> {
     Ok(())
 }
 
-fn print_stats(skel: &ScxMorpheusSkel) -> Result<()> {
-    // Read stats from the per-CPU array
-    let stats_map = &skel.maps.stats_map;
-    let key: u32 = 0;
-    let key_bytes = key.to_ne_bytes();
-
-    let mut total_hints = 0u64;
-    let mut total_dropped = 0u64;
-    let mut total_escalations = 0u64;
-    let mut total_blocked = 0u64;
-    let mut total_ticks = 0u64;
-
-    // Read and aggregate stats from the map
-    if let Ok(Some(bytes)) = stats_map.lookup(&key_bytes, libbpf_rs::MapFlags::ANY) {
-        // Parse the stats structure from bytes
-        // struct morpheus_stats is 5 x u64 = 40 bytes
-        let bytes: &[u8] = &bytes;
-        if bytes.len() >= 40 {
-            total_hints = u64::from_ne_bytes(bytes[0..8].try_into().unwrap_or([0u8; 8]));
-            total_dropped = u64::from_ne_bytes(bytes[8..16].try_into().unwrap_or([0u8; 8]));
-            total_escalations = u64::from_ne_bytes(bytes[16..24].try_into().unwrap_or([0u8; 8]));
-            total_blocked = u64::from_ne_bytes(bytes[24..32].try_into().unwrap_or([0u8; 8]));
-            total_ticks = u64::from_ne_bytes(bytes[32..40].try_into().unwrap_or([0u8; 8]));
+/// Fields of struct morpheus_stats, in declaration order
+const STATS_FIELDS: usize = 7;
+const STAT_HINTS: usize = 0;
+const STAT_DROPPED: usize = 1;
+const STAT_ESCALATIONS: usize = 2;
+const STAT_BLOCKED: usize = 3;
+const STAT_TICKS: usize = 4;
+const STAT_STEALS: usize = 6;
+
+/// Streaming aggregator for the per-CPU stats_map
+///
+/// stats_map is BPF_MAP_TYPE_PERCPU_ARRAY: a plain lookup returns one
+/// CPU's copy, so the old reader silently undercounted by a factor of
+/// nr_cpus. The aggregator fetches every per-CPU copy, keeps last-seen
+/// snapshots, and folds per-CPU deltas into monotonic totals - which
+/// also rides out counter resets across scheduler reloads (a value
+/// going backwards is treated as a fresh counter, not a negative
+/// delta). No allocation after the first refresh.
+struct StatsAggregator {
+    /// Last-seen per-CPU snapshots
+    last: Vec<[u64; STATS_FIELDS]>,
+    /// Monotonic totals accumulated from deltas
+    totals: [u64; STATS_FIELDS],
+}
+
+impl StatsAggregator {
+    fn new() -> Self {
+        Self {
+            last: Vec::new(),
+            totals: [0; STATS_FIELDS],
         }
     }
 
+    /// Fetch all per-CPU copies and fold their deltas into the totals
+    fn refresh(&mut self, skel: &ScxMorpheusSkel) {
+        let key = 0u32.to_ne_bytes();
+        let percpu = match skel
+            .maps
+            .stats_map
+            .lookup_percpu(&key, libbpf_rs::MapFlags::ANY)
+        {
+            Ok(Some(values)) => values,
+            _ => return,
+        };
+
+        if self.last.len() < percpu.len() {
+            self.last.resize(percpu.len(), [0; STATS_FIELDS]);
+        }
+
+        for (cpu, bytes) in percpu.iter().enumerate() {
+            for field in 0..STATS_FIELDS {
+                let offset = field * 8;
+                if bytes.len() < offset + 8 {
+                    break;
+                }
+                let value =
+                    u64::from_ne_bytes(bytes[offset..offset + 8].try_into().unwrap_or([0u8; 8]));
+                let prev = self.last[cpu][field];
+
+                // A counter going backwards means the scheduler was
+                // reloaded; the whole new value is the delta.
+                let delta = if value >= prev { value - prev } else { value };
+                self.totals[field] += delta;
+                self.last[cpu][field] = value;
+            }
+        }
+    }
+}
+
+fn print_stats(skel: &ScxMorpheusSkel, aggregator: &mut StatsAggregator) -> Result<()> {
+    aggregator.refresh(skel);
+    let totals = &aggregator.totals;
+
     info!(
-        "stats: ticks={} hints={} dropped={} escalations={} blocked={}",
-        total_ticks, total_hints, total_dropped, total_escalations, total_blocked
+        "stats: ticks={} hints={} dropped={} escalations={} blocked={} steals={}",
+        totals[STAT_TICKS],
+        totals[STAT_HINTS],
+        totals[STAT_DROPPED],
+        totals[STAT_ESCALATIONS],
+        totals[STAT_BLOCKED],
+        totals[STAT_STEALS]
     );
 
     Ok(())
 }
 
-fn adaptive_tune(skel: &ScxMorpheusSkel, default_slice_ns: u64, default_grace_ns: u64) -> Result<()> {
-    let num_cpus = std::thread::available_parallelism().map(|n| n.get()).unwrap_or(1) as u32;
-    let runqueue_depth = read_runqueue_depth().unwrap_or(0);
-
-    // Adaptive Slicing Logic
-    let new_slice_ns = if runqueue_depth > num_cpus * 2 {
-        // High load: prioritize responsiveness
-        2_000_000 // 2ms
-    } else if runqueue_depth < num_cpus {
-        // Low load: prioritize throughput (fewer yields)
-        10_000_000 // 10ms
-    } else {
-        // Moderate load: default
-        default_slice_ns
-    };
+/// Hard clamps and step size for the slice controller
+const SLICE_MIN_NS: u64 = 1_000_000; /* 1ms */
+const SLICE_MAX_NS: u64 = 20_000_000; /* 20ms */
+const SLICE_STEP_PCT: u64 = 20;
+/// Consecutive intervals pointing the same way before a change is applied
+const SLICE_HYSTERESIS: u32 = 3;
+/// Ack ratio above which workers count as "acking promptly"
+const PROMPT_ACK_RATIO: f64 = 0.9;
 
-    let config = MorpheusConfig {
-        slice_ns: new_slice_ns,
-        grace_period_ns: default_grace_ns,
-    };
+/// Closed-loop adaptive slice controller
+///
+/// Replaces the old loadavg heuristic (and the cron job that restarted
+/// the scheduler with new flags). Each interval it observes:
+///
+/// - hint->ack behavior from SCB preempt_seq / last_ack_seq movement
+/// - hint drop counts from stats_map
+/// - aggregate runqueue depth from global_pressure_map (timer-fed)
+///
+/// and nudges slice_ns: shorter when workers ack promptly and runqueues
+/// are deep (queueing delay dominates), longer when acks are prompt and
+/// the machine is idle enough that throughput matters, held otherwise.
+/// Changes require SLICE_HYSTERESIS consecutive intervals in the same
+/// direction and are clamped to [SLICE_MIN_NS, SLICE_MAX_NS].
+struct SliceController {
+    slice_ns: u64,
+    grace_ns: u64,
+    prev_preempt_total: u64,
+    prev_ack_total: u64,
+    prev_dropped: u64,
+    shrink_streak: u32,
+    grow_streak: u32,
+}
 
-    let key = 0u32.to_ne_bytes();
-    let val_bytes = unsafe {
-        std::slice::from_raw_parts(
-            &config as *const _ as *const u8,
-            std::mem::size_of::<MorpheusConfig>(),
-        )
-    };
+impl SliceController {
+    fn new(initial_slice_ns: u64, grace_ns: u64) -> Self {
+        Self {
+            slice_ns: initial_slice_ns.clamp(SLICE_MIN_NS, SLICE_MAX_NS),
+            grace_ns,
+            prev_preempt_total: 0,
+            prev_ack_total: 0,
+            prev_dropped: 0,
+            shrink_streak: 0,
+            grow_streak: 0,
+        }
+    }
 
-    skel.maps.config_map
-        .update(&key, val_bytes, libbpf_rs::MapFlags::ANY)
-        .context("Failed to update config_map")?;
+    /// Sum preempt_seq and last_ack_seq across RUNNING workers
+    fn observe_scbs(skel: &ScxMorpheusSkel) -> (u64, u64) {
+        let mut preempt_total = 0u64;
+        let mut ack_total = 0u64;
 
-    Ok(())
+        for worker_id in 0..morpheus_common::config::MAX_WORKERS {
+            let key = worker_id.to_ne_bytes();
+            let bytes = match skel.maps.scb_map.lookup(&key, libbpf_rs::MapFlags::ANY) {
+                Ok(Some(bytes)) if bytes.len() >= 192 => bytes,
+                _ => continue,
+            };
+
+            // SCB v2: worker_state at offset 4, preempt_seq at 8,
+            // last_ack_seq at 72
+            let state = u32::from_ne_bytes(bytes[4..8].try_into().unwrap_or([0u8; 4]));
+            if state != 2 {
+                // Not MORPHEUS_WORKER_STATE_RUNNING
+                continue;
+            }
+
+            preempt_total += u64::from_ne_bytes(bytes[8..16].try_into().unwrap_or([0u8; 8]));
+            ack_total += u64::from_ne_bytes(bytes[72..80].try_into().unwrap_or([0u8; 8]));
+        }
+
+        (preempt_total, ack_total)
+    }
+
+    /// Read the timer-fed aggregate runqueue depth
+    fn runqueue_depth(skel: &ScxMorpheusSkel) -> u32 {
+        let key = 0u32.to_ne_bytes();
+        match skel.maps.global_pressure_map.lookup(&key, libbpf_rs::MapFlags::ANY) {
+            Ok(Some(bytes)) if bytes.len() >= 16 => {
+                u32::from_ne_bytes(bytes[12..16].try_into().unwrap_or([0u8; 4]))
+            }
+            _ => 0,
+        }
+    }
+
+    /// Read the cumulative hint drop count from stats_map (all CPUs)
+    fn hints_dropped(skel: &ScxMorpheusSkel) -> u64 {
+        let key = 0u32.to_ne_bytes();
+        match skel.maps.stats_map.lookup_percpu(&key, libbpf_rs::MapFlags::ANY) {
+            Ok(Some(percpu)) => percpu
+                .iter()
+                .filter(|bytes| bytes.len() >= 16)
+                .map(|bytes| u64::from_ne_bytes(bytes[8..16].try_into().unwrap_or([0u8; 8])))
+                .sum(),
+            _ => 0,
+        }
+    }
+
+    /// Run one controller step and push any resulting config change
+    fn tune(&mut self, skel: &mut ScxMorpheusSkel) -> Result<()> {
+        let num_cpus = std::thread::available_parallelism()
+            .map(|n| n.get())
+            .unwrap_or(1) as u32;
+
+        let (preempt_total, ack_total) = Self::observe_scbs(skel);
+        let hints = preempt_total.saturating_sub(self.prev_preempt_total);
+        let acks = ack_total.saturating_sub(self.prev_ack_total);
+        self.prev_preempt_total = preempt_total;
+        self.prev_ack_total = ack_total;
+
+        let dropped_total = Self::hints_dropped(skel);
+        let dropped = dropped_total.saturating_sub(self.prev_dropped);
+        self.prev_dropped = dropped_total;
+
+        let depth = Self::runqueue_depth(skel);
+        let ack_ratio = if hints > 0 {
+            acks as f64 / hints as f64
+        } else {
+            1.0
+        };
+
+        // Controller decision. Hint drops mean hint volume is outrunning
+        // the sampled ring buffer - back off toward longer slices.
+        let want_shrink =
+            dropped == 0 && hints > 0 && ack_ratio >= PROMPT_ACK_RATIO && depth > num_cpus;
+        let want_grow = (dropped > 0 || ack_ratio >= PROMPT_ACK_RATIO) && depth < num_cpus / 2;
+
+        let new_slice_ns = if want_shrink {
+            self.shrink_streak += 1;
+            self.grow_streak = 0;
+            if self.shrink_streak >= SLICE_HYSTERESIS {
+                self.shrink_streak = 0;
+                (self.slice_ns - self.slice_ns * SLICE_STEP_PCT / 100).max(SLICE_MIN_NS)
+            } else {
+                self.slice_ns
+            }
+        } else if want_grow {
+            self.grow_streak += 1;
+            self.shrink_streak = 0;
+            if self.grow_streak >= SLICE_HYSTERESIS {
+                self.grow_streak = 0;
+                (self.slice_ns + self.slice_ns * SLICE_STEP_PCT / 100).min(SLICE_MAX_NS)
+            } else {
+                self.slice_ns
+            }
+        } else {
+            self.shrink_streak = 0;
+            self.grow_streak = 0;
+            self.slice_ns
+        };
+
+        if new_slice_ns == self.slice_ns {
+            return Ok(());
+        }
+
+        tracing::debug!(
+            "slice controller: {} -> {} ns (ack_ratio={:.2} depth={} dropped={})",
+            self.slice_ns,
+            new_slice_ns,
+            ack_ratio,
+            depth,
+            dropped
+        );
+        self.slice_ns = new_slice_ns;
+        self.push(skel)
+    }
+
+    /// Write the controller's current config to the BPF side
+    fn push(&self, skel: &mut ScxMorpheusSkel) -> Result<()> {
+        let config = MorpheusConfig {
+            slice_ns: self.slice_ns,
+            grace_period_ns: self.grace_ns,
+        };
+
+        let key = 0u32.to_ne_bytes();
+        let val_bytes = unsafe {
+            std::slice::from_raw_parts(
+                &config as *const _ as *const u8,
+                std::mem::size_of::<MorpheusConfig>(),
+            )
+        };
+
+        skel.maps
+            .config_map
+            .update(&key, val_bytes, libbpf_rs::MapFlags::ANY)
+            .context("Failed to update config_map")?;
+
+        // Tell the BPF side to refresh its per-CPU config caches
+        skel.maps.bss_data.config_generation =
+            skel.maps.bss_data.config_generation.wrapping_add(1);
+
+        Ok(())
+    }
 }
 
 /// Update global pressure from Linux PSI (Pressure Stall Information)
-fn update_global_pressure(skel: &ScxMorpheusSkel) -> Result<()> {
+///
+/// Only the three PSI percentages are fed from here; runqueue_depth is
+/// owned by the BPF pressure timer, so the current value is carried over.
+fn update_global_pressure(map: &libbpf_rs::MapHandle) -> Result<()> {
     let cpu_pressure = read_psi_avg10("/proc/pressure/cpu").unwrap_or(0);
     let io_pressure = read_psi_avg10("/proc/pressure/io").unwrap_or(0);
     let memory_pressure = read_psi_avg10("/proc/pressure/memory").unwrap_or(0);
 
-    // Calculate aggregate runqueue depth from /proc/loadavg
-    let runqueue_depth = read_runqueue_depth().unwrap_or(0);
+    let key = 0u32.to_ne_bytes();
+
+    // Preserve the timer-owned runqueue_depth field (offset 12)
+    let runqueue_depth = match map.lookup(&key, libbpf_rs::MapFlags::ANY) {
+        Ok(Some(cur)) if cur.len() >= 16 => {
+            u32::from_ne_bytes(cur[12..16].try_into().unwrap_or([0u8; 4]))
+        }
+        _ => 0,
+    };
 
     // Pack the global pressure struct (4 x u32 = 16 bytes)
     let mut value = [0u8; 16];
@@ -314,101 +794,140 @@ fn update_global_pressure(skel: &ScxMorpheusSkel) -> Result<()> {
     value[8..12].copy_from_slice(&memory_pressure.to_ne_bytes());
     value[12..16].copy_from_slice(&runqueue_depth.to_ne_bytes());
 
-    let key = 0u32.to_ne_bytes();
-    skel.maps
-        .global_pressure_map
-        .update(&key, &value, libbpf_rs::MapFlags::ANY)
+    map.update(&key, &value, libbpf_rs::MapFlags::ANY)
         .context("Failed to update global_pressure_map")?;
 
     Ok(())
 }
 
-/// Read PSI avg10 value from /proc/pressure/* files
-fn read_psi_avg10(path: &str) -> Option<u32> {
-    let content = std::fs::read_to_string(path).ok()?;
-    // Format: "some avg10=X.XX avg60=Y.YY avg300=Z.ZZ total=N"
-    for line in content.lines() {
-        if line.starts_with("some") {
-            if let Some(avg10_part) = line.split_whitespace().find(|s| s.starts_with("avg10=")) {
-                let value_str = avg10_part.strip_prefix("avg10=")?;
-                let value: f32 = value_str.parse().ok()?;
-                return Some(value.clamp(0.0, 100.0) as u32);
-            }
+/// Maximum LLC shards supported by the BPF side (MORPHEUS_MAX_LLCS)
+const MAX_LLCS: u32 = 64;
+
+/// Discover the cpu -> LLC mapping from sysfs cache topology
+///
+/// Returns a per-CPU vector of LLC ids plus the LLC count. CPUs sharing the
+/// same last-level cache (highest cache index in sysfs) get the same id.
+/// Falls back to a single shard (the old global-DSQ behavior) when the
+/// topology cannot be read.
+fn detect_llc_topology() -> (Vec<u32>, u32) {
+    let mut llc_ids: HashMap<String, u32> = HashMap::new();
+    let mut cpu_llcs = Vec::new();
+
+    for cpu in 0.. {
+        let cpu_dir = format!("/sys/devices/system/cpu/cpu{}", cpu);
+        if !std::path::Path::new(&cpu_dir).exists() {
+            break;
         }
-    }
-    None
-}
 
-/// Read runqueue depth from /proc/loadavg
-fn read_runqueue_depth() -> Option<u32> {
-    let content = std::fs::read_to_string("/proc/loadavg").ok()?;
-    // Format: "0.00 0.00 0.00 1/234 5678"
-    let parts: Vec<&str> = content.split_whitespace().collect();
-    if parts.len() >= 4 {
-        // Fourth field is running/total like "1/234"
-        let rq_parts: Vec<&str> = parts[3].split('/').collect();
-        if let Some(running) = rq_parts.first() {
-            return running.parse().ok();
+        // The highest populated cache index is the LLC (L3 on most parts,
+        // L2 on some VMs). Its shared_cpu_list uniquely identifies the domain.
+        let mut key = None;
+        for index in (0..=4).rev() {
+            let path = format!("{}/cache/index{}/shared_cpu_list", cpu_dir, index);
+            if let Ok(list) = std::fs::read_to_string(&path) {
+                key = Some(list.trim().to_string());
+                break;
+            }
         }
-    }
-    None
-}
 
-fn handle_escalation_event(event: &MorpheusEscalationEvent, pm: &Arc<Mutex<PenaltyManager>>) {
-    info!(
-        "ESCALATION: Worker {} (PID {}) - Severity {}",
-        event.worker_id, event.pid, event.severity
-    );
+        let key = match key {
+            Some(k) => k,
+            // No cache info for this CPU: collapse everything into shard 0
+            None => return (vec![0; cpu_llcs.len().max(1)], 1),
+        };
 
-    let pid = event.pid;
-    let mut guard = pm.lock().unwrap();
+        let next_id = llc_ids.len() as u32;
+        let id = *llc_ids.entry(key).or_insert(next_id);
+        cpu_llcs.push(id);
+    }
 
-    if guard.active_penalties.contains_key(&pid) {
-        return; // Already penalized
+    let nr_llcs = llc_ids.len() as u32;
+    if cpu_llcs.is_empty() || nr_llcs == 0 || nr_llcs > MAX_LLCS {
+        return (vec![0; cpu_llcs.len().max(1)], 1);
     }
 
-    // Find Cgroup
-    if let Ok(cgroup_path) = find_cgroup_path(pid) {
-        let max_file = format!("{}/cpu.max", cgroup_path);
-
-        // Read current
-        if let Ok(current) = std::fs::read_to_string(&max_file) {
-            // Write penalty (1000 100000 = 1%)
-            if std::fs::write(&max_file, "1000 100000").is_ok() {
-                info!("  -> Throttled cgroup {} to 1%", max_file);
-                // Store original value to restore later
-                guard.active_penalties.insert(
-                    pid,
-                    (current, std::time::Instant::now() + Duration::from_secs(5)),
-                );
-            } else {
-                tracing::error!("  -> Failed to write to {}", max_file);
+    (cpu_llcs, nr_llcs)
+}
+
+/// Discover the cpu -> NUMA node mapping from sysfs
+///
+/// Returns a per-CPU vector of node ids plus the node count. Falls back
+/// to a single node (disabling the cross-node gate) when the topology
+/// cannot be read.
+fn detect_node_topology(nr_cpus: usize) -> (Vec<u32>, u32) {
+    let mut cpu_nodes = vec![0u32; nr_cpus];
+    let mut nr_nodes = 0u32;
+
+    // Enumerate node directories rather than counting up from node0:
+    // node ids can be sparse on memory-hotplug systems.
+    let entries = match std::fs::read_dir("/sys/devices/system/node") {
+        Ok(entries) => entries,
+        Err(_) => return (cpu_nodes, 1),
+    };
+
+    for entry in entries.flatten() {
+        let name = entry.file_name();
+        let name = name.to_string_lossy();
+        let node: usize = match name.strip_prefix("node").and_then(|n| n.parse().ok()) {
+            Some(node) => node,
+            None => continue,
+        };
+
+        let cpulist_path = format!("/sys/devices/system/node/node{}/cpulist", node);
+        let cpulist = match std::fs::read_to_string(&cpulist_path) {
+            Ok(list) => list,
+            Err(_) => continue,
+        };
+
+        for cpu in parse_cpu_list(&cpulist) {
+            if cpu < nr_cpus {
+                cpu_nodes[cpu] = node as u32;
             }
         }
+        nr_nodes += 1;
     }
+
+    if nr_nodes == 0 {
+        return (cpu_nodes, 1);
+    }
+
+    (cpu_nodes, nr_nodes)
 }
 
-fn check_expired_penalties(pm: &Arc<Mutex<PenaltyManager>>) {
-    let mut guard = pm.lock().unwrap();
-    let now = std::time::Instant::now();
-    let mut expired = Vec::new();
+/// Parse a sysfs cpulist like "0-63,128-191" into cpu indices
+fn parse_cpu_list(list: &str) -> Vec<usize> {
+    let mut cpus = Vec::new();
 
-    for (pid, (_, expiry)) in guard.active_penalties.iter() {
-        if now >= *expiry {
-            expired.push(*pid);
+    for part in list.trim().split(',') {
+        if part.is_empty() {
+            continue;
+        }
+        if let Some((start, end)) = part.split_once('-') {
+            if let (Ok(start), Ok(end)) = (start.parse::<usize>(), end.parse::<usize>()) {
+                cpus.extend(start..=end);
+            }
+        } else if let Ok(cpu) = part.parse::<usize>() {
+            cpus.push(cpu);
         }
     }
 
-    for pid in expired {
-        if let Some((original, _)) = guard.active_penalties.remove(&pid) {
-            if let Ok(cgroup_path) = find_cgroup_path(pid) {
-                let max_file = format!("{}/cpu.max", cgroup_path);
-                if std::fs::write(&max_file, &original).is_ok() {
-                    info!("  -> Restored quota for PID {}", pid);
-                }
+    cpus
+}
+
+/// Read PSI avg10 value from /proc/pressure/* files
+fn read_psi_avg10(path: &str) -> Option<u32> {
+    let content = std::fs::read_to_string(path).ok()?;
+    // Format: "some avg10=X.XX avg60=Y.YY avg300=Z.ZZ total=N"
+    for line in content.lines() {
+        if line.starts_with("some") {
+            if let Some(avg10_part) = line.split_whitespace().find(|s| s.starts_with("avg10=")) {
+                let value_str = avg10_part.strip_prefix("avg10=")?;
+                let value: f32 = value_str.parse().ok()?;
+                return Some(value.clamp(0.0, 100.0) as u32);
             }
         }
     }
+    None
 }
 
 fn find_cgroup_path(pid: u32) -> Result<String> {